@@ -0,0 +1,112 @@
+#include "commandbenchmark.h"
+#include "commandchannel.h"
+#include "mockcontroller.h"
+
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+namespace {
+
+const int pipelineWindow = 256;
+const int maxDelayedSequential = 50;
+
+/**
+ * @struct RunResult
+ * @brief Measurements of one benchmark run.
+ */
+struct RunResult {
+    std::vector<qint64> latenciesNs; ///< Round trip of every answered command.
+    int unanswered = 0;              ///< Commands that failed or timed out.
+    qint64 wallNs = 0;               ///< Time of the whole run.
+    bool finished = false;           ///< Whether the run has completed.
+};
+
+void record(RunResult &result, const CommandResult &command) {
+    if (command.outcome == CommandOutcome::ACKNOWLEDGED)
+        result.latenciesNs.push_back(command.latencyNs);
+    else
+        ++result.unanswered;
+}
+
+CommandTask sendCommands(CommandChannel &channel, int count, int window, RunResult &result, QEventLoop &loop) {
+    QElapsedTimer timer;
+    timer.start();
+
+    std::deque<CommandAwaiter> inFlight;
+    for (int i = 0; i < count; ++i) {
+        inFlight.push_back(channel.send(ControllerWidget::BLOCK_COUNT + i, ScheduleAction::SET_TEMPERATURE, 22));
+        if (static_cast<int>(inFlight.size()) >= window) {
+            record(result, co_await inFlight.front());
+            inFlight.pop_front();
+        }
+    }
+    while (!inFlight.empty()) {
+        record(result, co_await inFlight.front());
+        inFlight.pop_front();
+    }
+
+    result.wallNs = timer.nsecsElapsed();
+    result.finished = true;
+    loop.quit();
+}
+
+void report(const QString &name, RunResult &result) {
+    std::vector<qint64> &latencies = result.latenciesNs;
+    std::sort(latencies.begin(), latencies.end());
+    const int count = static_cast<int>(latencies.size()) + result.unanswered;
+
+    auto percentileMs = [&](double fraction) {
+        if (latencies.empty())
+            return 0.0;
+        const size_t index = std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()));
+        return latencies[index] / 1e6;
+    };
+
+    qInfo().noquote() << QString("%1: %2 commands in %3 ms, %4 commands/s, round trip p50 %5 ms, p99 %6 ms, max %7 ms, %8 unanswered")
+                             .arg(name).arg(count).arg(result.wallNs / 1e6, 0, 'f', 1)
+                             .arg(count * 1e9 / std::max<qint64>(1, result.wallNs), 0, 'f', 0)
+                             .arg(percentileMs(0.5), 0, 'f', 3).arg(percentileMs(0.99), 0, 'f', 3)
+                             .arg(latencies.empty() ? 0.0 : latencies.back() / 1e6, 0, 'f', 3)
+                             .arg(result.unanswered);
+}
+
+}
+
+int runCommandBenchmark(int commands) {
+    CommandChannel channel;
+    QObject controller;
+    bool delayed = false;
+
+    QObject::connect(&channel, &CommandChannel::commandIssued, &controller, [&](const ControllerCommand &command) {
+        const int latencyMs = delayed ? MockController::MIN_ACK_LATENCY_MS
+                                        + std::rand() % (MockController::MAX_ACK_LATENCY_MS - MockController::MIN_ACK_LATENCY_MS + 1)
+                                      : 0;
+        QTimer::singleShot(latencyMs, &controller, [&channel, id = command.id]() { channel.acknowledge(id, true); });
+    });
+
+    auto run = [&](const QString &name, int count, int window) {
+        QEventLoop loop;
+        RunResult result;
+        sendCommands(channel, count, window, result, loop);
+        if (!result.finished)
+            loop.exec();
+        report(name, result);
+    };
+
+    run("sequential, immediate answer", commands, 1);
+    run(QString("pipelined x%1, immediate answer").arg(pipelineWindow), commands, pipelineWindow);
+
+    delayed = true;
+    run(QString("sequential, %1-%2 ms answer").arg(MockController::MIN_ACK_LATENCY_MS).arg(MockController::MAX_ACK_LATENCY_MS),
+        std::min(commands, maxDelayedSequential), 1);
+    run(QString("pipelined x%1, %2-%3 ms answer").arg(commands).arg(MockController::MIN_ACK_LATENCY_MS).arg(MockController::MAX_ACK_LATENCY_MS),
+        commands, commands);
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef COMMANDBENCHMARK_H
+#define COMMANDBENCHMARK_H
+
+/**
+ * @file commandbenchmark.h
+ * @brief Measures command round-trip latency and throughput of CommandChannel.
+ */
+
+/**
+ * @brief Sends commands one at a time and pipelined, and prints latency percentiles and throughput.
+ *
+ * The commands are answered by a stand-in controller, first immediately to
+ * measure the overhead of the channel itself, then after the same delay the
+ * MockController simulates.
+ *
+ * @param commands Number of commands per run.
+ * @return Process exit code.
+ */
+int runCommandBenchmark(int commands);
+
+#endif // COMMANDBENCHMARK_H
@@ -0,0 +1,95 @@
+#include "commandchannel.h"
+#include "metrics.h"
+
+#include <QMetaMethod>
+#include <utility>
+
+namespace {
+
+const int expiryIntervalMs = 10;
+
+}
+
+CommandChannel::CommandChannel(QObject *parent) : QObject(parent) {
+    clock.start();
+
+    expiryTimer.setInterval(expiryIntervalMs);
+    connect(&expiryTimer, &QTimer::timeout, this, &CommandChannel::expire);
+}
+
+CommandChannel::~CommandChannel() {
+    for (auto &entry : pending) {
+        if (entry.second.state->waiter)
+            std::exchange(entry.second.state->waiter, {}).destroy();
+    }
+}
+
+CommandAwaiter CommandChannel::send(int unit, ScheduleAction action, int value, int timeoutMs) {
+    std::shared_ptr<CommandState> state = std::make_shared<CommandState>();
+
+    if (!isSignalConnected(QMetaMethod::fromSignal(&CommandChannel::commandIssued))) {
+        MetricsRegistry::instance().observeCommand(CommandOutcome::NO_CONTROLLER, 0);
+        state->result.outcome = CommandOutcome::NO_CONTROLLER;
+        state->done = true;
+        return CommandAwaiter(state);
+    }
+
+    ControllerCommand command;
+    command.id = nextId++;
+    command.unit = unit;
+    command.action = action;
+    command.value = value;
+
+    // The wheel advances one tick per millisecond, so skip the idle time instead of replaying it.
+    const quint64 now = static_cast<quint64>(clock.elapsed());
+    if (pending.empty())
+        deadlines.reset(now);
+    deadlines.schedule(now + static_cast<quint64>(timeoutMs), command.id);
+    if (!expiryTimer.isActive())
+        expiryTimer.start();
+
+    pending.emplace(command.id, Pending{state, clock.nsecsElapsed()});
+    emit commandIssued(command);
+    return CommandAwaiter(state);
+}
+
+int CommandChannel::pendingCount() const {
+    return static_cast<int>(pending.size());
+}
+
+void CommandChannel::acknowledge(quint64 id, bool success) {
+    complete(id, success ? CommandOutcome::ACKNOWLEDGED : CommandOutcome::FAILED);
+}
+
+void CommandChannel::expire() {
+    expired.clear();
+    deadlines.advance(static_cast<quint64>(clock.elapsed()), expired);
+    for (quint64 id : expired)
+        complete(id, CommandOutcome::TIMED_OUT);
+
+    if (pending.empty())
+        expiryTimer.stop();
+}
+
+void CommandChannel::complete(quint64 id, CommandOutcome outcome) {
+    auto it = pending.find(id);
+    if (it == pending.end())
+        return;
+
+    std::shared_ptr<CommandState> state = std::move(it->second.state);
+    const qint64 latencyNs = clock.nsecsElapsed() - it->second.sentNs;
+    pending.erase(it);
+    if (pending.empty()) {
+        // The remaining deadlines all belong to answered commands.
+        deadlines.clear();
+        expiryTimer.stop();
+    }
+
+    MetricsRegistry::instance().observeCommand(outcome, latencyNs);
+
+    state->result.outcome = outcome;
+    state->result.latencyNs = latencyNs;
+    state->done = true;
+    if (state->waiter)
+        std::exchange(state->waiter, {}).resume();
+}
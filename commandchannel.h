@@ -0,0 +1,222 @@
+#ifndef COMMANDCHANNEL_H
+#define COMMANDCHANNEL_H
+
+/**
+ * @file commandchannel.h
+ * @brief Defines awaitable commands sent to controllers.
+ *
+ * A command is issued as soon as CommandChannel::send() is called and can be
+ * awaited later with co_await, so several commands can be in flight at once.
+ * Coroutines run on the Qt event loop: they are suspended while waiting and
+ * resumed from the slot that receives the acknowledgement or the timeout.
+ */
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "scheduleengine.h"
+#include "timerwheel.h"
+
+/**
+ * @enum CommandOutcome
+ * @brief How a command ended.
+ */
+enum class CommandOutcome {
+    ACKNOWLEDGED,  ///< The controller applied the command
+    FAILED,        ///< The controller rejected the command
+    TIMED_OUT,     ///< No answer arrived in time
+    NO_CONTROLLER  ///< No controller was connected to receive the command
+};
+
+/**
+ * @struct ControllerCommand
+ * @brief A command as seen by controllers.
+ */
+struct ControllerCommand {
+    quint64 id = 0;                                  ///< Identifier to pass to CommandChannel::acknowledge().
+    int unit = 0;                                    ///< Target unit; units below ControllerWidget::BLOCK_COUNT address the local system.
+    ScheduleAction action = ScheduleAction::TURN_ON; ///< Command.
+    int value = 0;                                   ///< Temperature in Celsius or AirFlowDirection index.
+};
+
+/**
+ * @struct CommandResult
+ * @brief Result of an awaited command.
+ */
+struct CommandResult {
+    CommandOutcome outcome = CommandOutcome::TIMED_OUT; ///< How the command ended.
+    qint64 latencyNs = 0;                               ///< Time from sending to the outcome.
+};
+
+/**
+ * @struct CommandState
+ * @brief State shared between a pending command and its awaiter.
+ */
+struct CommandState {
+    CommandResult result;            ///< Valid once done is set.
+    bool done = false;               ///< Whether the command has ended.
+    std::coroutine_handle<> waiter;  ///< Coroutine suspended on the command, if any.
+};
+
+/**
+ * @class CommandAwaiter
+ * @brief Awaitable handle to a command that has already been sent.
+ *
+ * co_await yields a CommandResult. Dropping the awaiter does not cancel the command.
+ */
+class CommandAwaiter {
+public:
+    /**
+     * @brief Returns whether the command has already ended.
+     */
+    bool await_ready() const noexcept { return state->done; }
+
+    /**
+     * @brief Suspends the awaiting coroutine until the command ends.
+     * @param handle The awaiting coroutine.
+     */
+    void await_suspend(std::coroutine_handle<> handle) noexcept { state->waiter = handle; }
+
+    /**
+     * @brief Returns the result of the command.
+     */
+    CommandResult await_resume() const noexcept { return state->result; }
+
+private:
+    friend class CommandChannel;
+
+    /**
+     * @brief Constructor.
+     * @param state State of the sent command.
+     */
+    explicit CommandAwaiter(std::shared_ptr<CommandState> state) : state(std::move(state)) {}
+
+    std::shared_ptr<CommandState> state; ///< State of the sent command.
+};
+
+/**
+ * @class CommandTask
+ * @brief Return type of fire-and-forget coroutines that await commands.
+ *
+ * The coroutine starts immediately and frees itself when it returns. If the
+ * CommandChannel it waits on is destroyed first, the coroutine is destroyed
+ * without being resumed.
+ */
+class CommandTask {
+public:
+    /**
+     * @struct promise_type
+     * @brief Coroutine promise required by the compiler.
+     */
+    struct promise_type {
+        CommandTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+/**
+ * @class CommandChannel
+ * @brief Sends commands to controllers and completes them on acknowledgement or timeout.
+ *
+ * Controllers connect to commandIssued() and answer every command they own
+ * with acknowledge(). Several controllers may share one channel, each
+ * answering the units it manages. Deadlines are kept in a TimerWheel with
+ * millisecond ticks that is only polled while commands are pending.
+ * Deadlines of answered commands stay in the wheel and are ignored when they
+ * fire; the wheel is cleared as soon as no command is pending.
+ */
+class CommandChannel : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Default time a controller has to answer, in milliseconds.
+     */
+    static constexpr int DEFAULT_TIMEOUT_MS = 2000;
+
+    /**
+     * @brief Constructor.
+     * @param parent Optional parent.
+     */
+    explicit CommandChannel(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor. Destroys coroutines still waiting on pending commands.
+     */
+    ~CommandChannel();
+
+    /**
+     * @brief Sends a command.
+     *
+     * Without any connected controller the command completes at once with
+     * CommandOutcome::NO_CONTROLLER, so nothing is treated as applied that
+     * no controller confirmed.
+     *
+     * @param unit Target unit.
+     * @param action Command.
+     * @param value Temperature in Celsius or AirFlowDirection index.
+     * @param timeoutMs Time the controller has to answer.
+     * @return Awaitable completing with the outcome.
+     */
+    CommandAwaiter send(int unit, ScheduleAction action, int value = 0, int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    /**
+     * @brief Returns the number of commands waiting for an answer.
+     */
+    int pendingCount() const;
+
+public slots:
+    /**
+     * @brief Completes a pending command. Answers to unknown or expired commands are ignored.
+     * @param id Identifier of the command.
+     * @param success Whether the controller applied the command.
+     */
+    void acknowledge(quint64 id, bool success);
+
+signals:
+    /**
+     * @brief Emitted for every sent command.
+     * @param command The command to apply and acknowledge.
+     */
+    void commandIssued(const ControllerCommand &command);
+
+private slots:
+    /**
+     * @brief Completes all commands whose deadline has passed.
+     */
+    void expire();
+
+private:
+    /**
+     * @struct Pending
+     * @brief A command waiting for an answer.
+     */
+    struct Pending {
+        std::shared_ptr<CommandState> state; ///< State shared with the awaiter.
+        qint64 sentNs = 0;                   ///< Channel clock when the command was sent.
+    };
+
+    /**
+     * @brief Ends a pending command and resumes its waiting coroutine.
+     * @param id Identifier of the command.
+     * @param outcome How the command ended.
+     */
+    void complete(quint64 id, CommandOutcome outcome);
+
+    std::unordered_map<quint64, Pending> pending; ///< Commands waiting for an answer.
+    TimerWheel deadlines;     ///< Command identifiers keyed by deadline in milliseconds of clock, cleared whenever pending empties.
+    std::vector<quint64> expired; ///< Scratch buffer for expire().
+    QTimer expiryTimer;       ///< Polls the deadlines while commands are pending.
+    QElapsedTimer clock;      ///< Time base of deadlines and latencies.
+    quint64 nextId = 1;       ///< Identifier of the next command.
+};
+
+#endif // COMMANDCHANNEL_H
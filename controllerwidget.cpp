@@ -1,5 +1,19 @@
 #include "controllerwidget.h"
 #include "mockcontroller.h"
+#include "unittablemodel.h"
+#include "unitlistwidget.h"
+#include "telemetrythrottle.h"
+#include "metrics.h"
+#include "themeengine.h"
+#include "sharedstatetable.h"
+#include "energyanalytics.h"
+
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QTableWidget>
+#include <QTimeEdit>
+#include <QHeaderView>
+#include <QSignalBlocker>
 
 ControllerWidget::ControllerWidget(QWidget *parent) : QWidget(parent) {
 
@@ -10,6 +24,14 @@ ControllerWidget::ControllerWidget(QWidget *parent) : QWidget(parent) {
     sizePolicy.setHeightForWidth(true);
     setSizePolicy(sizePolicy);
 
+    themeEngine = new ThemeEngine(this);
+
+    unitTable = new UnitTableModel(this);
+    unitTable->resize(BLOCK_COUNT);
+    telemetry = new TelemetryThrottle(this, this);
+    schedule = new ScheduleEngine(this);
+    commands = new CommandChannel(this);
+
     scene = new QGraphicsScene(this);
     QGraphicsView *view = new QGraphicsView(scene);
     view->setFixedSize(600, 200);
@@ -17,9 +39,6 @@ ControllerWidget::ControllerWidget(QWidget *parent) : QWidget(parent) {
     block1 = new QGraphicsRectItem(0, 0, 160, 160);
     block2 = new QGraphicsRectItem(200, 0, 160, 160);
     block3 = new QGraphicsRectItem(400, 0, 160, 160);
-    block1->setBrush(Qt::gray);
-    block2->setBrush(Qt::gray);
-    block3->setBrush(Qt::gray);
     scene->addItem(block1);
     scene->addItem(block2);
     scene->addItem(block3);
@@ -33,7 +52,7 @@ ControllerWidget::ControllerWidget(QWidget *parent) : QWidget(parent) {
 
     powerButton = new QPushButton("Включить", this);
     powerButton->setCheckable(true);
-    powerButton->setStyleSheet("QPushButton { min-width: 100px; min-height: 50px; }");
+    powerButton->setMinimumSize(100, 50);
 
     tempSlider = new QSlider(Qt::Horizontal, this);
     tempSlider->setRange(16, 30);
@@ -55,6 +74,8 @@ ControllerWidget::ControllerWidget(QWidget *parent) : QWidget(parent) {
 
     themeButton = new QPushButton("Сменить тему", this);
     simulateButton = new QPushButton("Имитация данных", this);
+    unitListButton = new QPushButton("Список блоков", this);
+    scheduleButton = new QPushButton("Расписание", this);
 
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     QHBoxLayout *topLayout = new QHBoxLayout();
@@ -80,22 +101,52 @@ ControllerWidget::ControllerWidget(QWidget *parent) : QWidget(parent) {
     controlLayout->addWidget(airflowSelectLabel);
     controlLayout->addWidget(airflowCombo);
 
+    // Unit selection and the buttons share rows so the energy panel fits
+    // within the maximum window height.
+    QHBoxLayout *unitLayout = new QHBoxLayout();
+    unitLayout->addWidget(unitSelectLabel);
+    unitLayout->addWidget(tempUnitCombo);
+    unitLayout->addWidget(pressureUnitCombo);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(themeButton);
+    buttonLayout->addWidget(simulateButton);
+    buttonLayout->addWidget(unitListButton);
+    buttonLayout->addWidget(scheduleButton);
+
     mainLayout->addLayout(topLayout);
     mainLayout->addLayout(statusLayout);
     mainLayout->addLayout(controlLayout);
-    mainLayout->addWidget(unitSelectLabel);
-    mainLayout->addWidget(tempUnitCombo);
-    mainLayout->addWidget(pressureUnitCombo);
-    mainLayout->addWidget(themeButton);
-    mainLayout->addWidget(simulateButton);
+    mainLayout->addLayout(unitLayout);
+    mainLayout->addLayout(buttonLayout);
+
+    energyHistory.assign(BLOCK_COUNT, EnergyHistory(ENERGY_SAMPLE_INTERVAL_SEC));
+    createEnergyPanel();
+    mainLayout->addWidget(energyGroup);
 
     connect(powerButton, &QPushButton::clicked, this, &ControllerWidget::toggleSystem);
     connect(tempSlider, &QSlider::valueChanged, this, &ControllerWidget::updateTemperatureRequest);
+    connect(tempSlider, &QSlider::sliderReleased, this, &ControllerWidget::sendTemperatureRequest);
     connect(airflowCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ControllerWidget::updateAirflowDirectionRequest);
     connect(tempUnitCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ControllerWidget::changeTemperatureUnit);
     connect(pressureUnitCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &ControllerWidget::changePressureUnit);
     connect(themeButton, &QPushButton::clicked, this, &ControllerWidget::toggleTheme);
     connect(simulateButton, &QPushButton::clicked, this, &ControllerWidget::showSimulationDialog);
+    connect(unitListButton, &QPushButton::clicked, this, &ControllerWidget::showUnitList);
+    connect(scheduleButton, &QPushButton::clicked, this, &ControllerWidget::showScheduleDialog);
+    connect(schedule, &ScheduleEngine::commandsDue, this, &ControllerWidget::applyScheduledCommands);
+
+    historyEpochMs = QDateTime::currentMSecsSinceEpoch();
+    historyClock.start();
+    historyTimer = new QTimer(this);
+    historyTimer->setInterval(60 * 1000);
+    connect(historyTimer, &QTimer::timeout, this, &ControllerWidget::maintainHistory);
+    historyTimer->start();
+
+    energyTimer = new QTimer(this);
+    energyTimer->setInterval(ENERGY_SAMPLE_INTERVAL_SEC * 1000);
+    connect(energyTimer, &QTimer::timeout, this, &ControllerWidget::recordEnergySample);
+    energyTimer->start();
 
     updateBlockColor(block1, BlockStatus::BLOCK_OFF);
     updateBlockColor(block2, BlockStatus::BLOCK_OFF);
@@ -122,68 +173,219 @@ ControllerWidget::ControllerWidget(QWidget *parent) : QWidget(parent) {
     pressureUnitCombo->setFont(font);
     themeButton->setFont(font);
     simulateButton->setFont(font);
-    tempSlider->setSliderPosition(0);
+    unitListButton->setFont(font);
+    scheduleButton->setFont(font);
+    {
+        // Initial position only; nothing is sent to the controller.
+        const QSignalBlocker blocker(tempSlider);
+        tempSlider->setSliderPosition(0);
+    }
+    currentDesiredTempC = tempSlider->value();
+    acknowledgedTemperature = tempSlider->value();
+
+    temperatureSendTimer = new QTimer(this);
+    temperatureSendTimer->setSingleShot(true);
+    temperatureSendTimer->setInterval(300);
+    connect(temperatureSendTimer, &QTimer::timeout, this, &ControllerWidget::sendTemperatureRequest);
 
     loadSettings();
     updateDisplay();
 
 
+    // The simulation dialog is where a backend is attached, so it stays
+    // available while the system is off.
     tempSlider->setDisabled(true);
     airflowCombo->setDisabled(true);
-    simulateButton->setDisabled(true);
 }
 
 void ControllerWidget::toggleSystem() {
-    isSystemOn = !isSystemOn;
-    if(isSystemOn)
-    {
-        tempSlider->setDisabled(false);
-        airflowCombo->setDisabled(false);
-        simulateButton->setDisabled(false);
+    const bool on = powerButton->isChecked();
+    if (powerCommandPending || on == isSystemOn) {
+        powerButton->setChecked(isSystemOn);
+        return;
+    }
+    switchSystem(on);
+}
+
+CommandTask ControllerWidget::switchSystem(bool on) {
+    powerCommandPending = true;
+    powerButton->setEnabled(false);
+    powerButton->setText(on ? "Включение..." : "Выключение...");
+
+    const CommandResult result = co_await commands->send(0, on ? ScheduleAction::TURN_ON : ScheduleAction::TURN_OFF);
+
+    powerCommandPending = false;
+    powerButton->setEnabled(true);
+    if (result.outcome == CommandOutcome::ACKNOWLEDGED) {
+        isSystemOn = on;
+        if (on)
+            emit(turnOnRequest());
+        else
+            emit(turnOffRequest());
+    }
+    else {
+        reportCommandFailure(on ? "Включение системы" : "Выключение системы", result.outcome);
+    }
+    applyPowerState();
 
-        powerButton->setText("Выключить");
-        emit(turnOnRequest());
+    if (scheduledPowerDeferred) {
+        scheduledPowerDeferred = false;
+        powerButton->setToolTip(QString());
+        applyScheduledPower(scheduledPowerOn);
     }
+    applyDeferredSettings();
+}
+
+void ControllerWidget::applyScheduledPower(bool on) {
+    if (powerCommandPending) {
+        scheduledPowerDeferred = true;
+        scheduledPowerOn = on;
+        powerButton->setToolTip(QString("По расписанию: %1 после ответа контроллера").arg(on ? "включить" : "выключить"));
+        return;
+    }
+    if (on != isSystemOn) {
+        powerButton->setChecked(on);
+        switchSystem(on);
+    }
+}
+
+void ControllerWidget::applyScheduledSetting(ScheduleAction action, int value) {
+    const bool temperature = action == ScheduleAction::SET_TEMPERATURE;
+    if (!isSystemOn || powerCommandPending) {
+        if (temperature) {
+            scheduledTemperatureDeferred = true;
+            scheduledTemperature = value;
+        }
+        else {
+            scheduledAirflowDeferred = true;
+            scheduledAirflow = value;
+        }
+        return;
+    }
+
+    if (temperature)
+        tempSlider->setValue(value);
     else
-    {
-        tempSlider->setDisabled(true);
-        airflowCombo->setDisabled(true);
-        simulateButton->setDisabled(true);
+        airflowCombo->setCurrentIndex(value);
+}
+
+void ControllerWidget::applyDeferredSettings() {
+    if (!isSystemOn || powerCommandPending)
+        return;
 
-        powerButton->setText("Включить");
-        emit(turnOffRequest());
+    if (scheduledTemperatureDeferred) {
+        scheduledTemperatureDeferred = false;
+        applyScheduledSetting(ScheduleAction::SET_TEMPERATURE, scheduledTemperature);
     }
+    if (scheduledAirflowDeferred) {
+        scheduledAirflowDeferred = false;
+        applyScheduledSetting(ScheduleAction::SET_AIRFLOW, scheduledAirflow);
+    }
+}
+
+CommandTask ControllerWidget::sendSetting(ScheduleAction action, int value) {
+    const bool temperature = action == ScheduleAction::SET_TEMPERATURE;
+    const quint64 serial = temperature ? ++temperatureSerial : ++airflowSerial;
+
+    const CommandResult result = co_await commands->send(0, action, value);
+
+    if (serial != (temperature ? temperatureSerial : airflowSerial))
+        co_return;
+
+    if (result.outcome == CommandOutcome::ACKNOWLEDGED) {
+        if (temperature) {
+            acknowledgedTemperature = value;
+            emit(desiredTemperatureChanged(value));
+        }
+        else {
+            acknowledgedAirflow = static_cast<AirFlowDirection>(value);
+            emit(desiredAirFlowChanged(acknowledgedAirflow));
+        }
+        co_return;
+    }
+
+    // A value the user is still choosing replaces the failed one anyway.
+    if (!temperature || !(tempSlider->isSliderDown() || temperatureSendTimer->isActive()))
+        revertSetting(action);
+    reportCommandFailure(temperature ? QString("Температура %1 °C").arg(value) : QString("Направление воздуха"),
+                         result.outcome);
+}
+
+void ControllerWidget::revertSetting(ScheduleAction action) {
+    if (action == ScheduleAction::SET_TEMPERATURE) {
+        const QSignalBlocker blocker(tempSlider);
+        tempSlider->setValue(acknowledgedTemperature);
+        currentDesiredTempC = acknowledgedTemperature;
+    }
+    else {
+        const QSignalBlocker blocker(airflowCombo);
+        airflowCombo->setCurrentIndex(static_cast<int>(acknowledgedAirflow));
+    }
+    updateDisplay();
+}
+
+void ControllerWidget::applyPowerState() {
+    powerButton->setChecked(isSystemOn);
+    powerButton->setText(isSystemOn ? "Выключить" : "Включить");
+    tempSlider->setDisabled(!isSystemOn);
+    airflowCombo->setDisabled(!isSystemOn);
+}
+
+void ControllerWidget::reportCommandFailure(const QString &what, CommandOutcome outcome) {
+    const QString reason = outcome == CommandOutcome::FAILED ? "контроллер отклонил команду"
+                         : outcome == CommandOutcome::NO_CONTROLLER ? "нет подключённого контроллера"
+                                                                    : "контроллер не ответил";
+    QMessageBox *box = new QMessageBox(QMessageBox::Warning, "Команда не выполнена",
+                                       QString("%1: %2.").arg(what, reason), QMessageBox::Ok, this);
+    box->setAttribute(Qt::WA_WindowPropagation);
+    box->setAttribute(Qt::WA_DeleteOnClose);
+    box->open();
 }
 
 void ControllerWidget::updateTemperatureRequest(int value)
 {
     currentDesiredTempC = value;
     updateDisplay();
-    emit(desiredTemperatureChanged(value));
+    // While dragging, the value is sent when the slider is released.
+    if (!tempSlider->isSliderDown())
+        temperatureSendTimer->start();
+}
+
+void ControllerWidget::sendTemperatureRequest()
+{
+    temperatureSendTimer->stop();
+    sendSetting(ScheduleAction::SET_TEMPERATURE, tempSlider->value());
 }
 
 void ControllerWidget::updateAirflowDirectionRequest(int index)
 {
-    emit(desiredAirFlowChanged(static_cast<AirFlowDirection>(index)));
+    sendSetting(ScheduleAction::SET_AIRFLOW, index);
 }
 
 void ControllerWidget::updateTemperature(double value) {
+    MetricsRegistry::instance().countSlotUpdate(MetricsSlot::UPDATE_TEMPERATURE);
     currentTempC = value;
+    temperatureHistory.append(historyTimestamp(), value);
     updateDisplay();
 }
 
 void ControllerWidget::updateAirflowDirection(AirFlowDirection dir) {
+    MetricsRegistry::instance().countSlotUpdate(MetricsSlot::UPDATE_AIRFLOW);
     currentAirflowSetting = dir;
     updateDisplay();
 }
 
 void ControllerWidget::updatePressure(double value) {
+    MetricsRegistry::instance().countSlotUpdate(MetricsSlot::UPDATE_PRESSURE);
     currentPressurePa = value;
+    pressureHistory.append(historyTimestamp(), value);
     updateDisplay();
 
 }
 void ControllerWidget::updateHumidity(double value) {
+    MetricsRegistry::instance().countSlotUpdate(MetricsSlot::UPDATE_HUMIDITY);
     currentHumidity = value;
+    humidityHistory.append(historyTimestamp(), value);
     updateDisplay();
 }
 
@@ -199,6 +401,9 @@ void ControllerWidget::changePressureUnit(int index) {
 }
 
 void ControllerWidget::updateDisplay() {
+    QElapsedTimer timer;
+    timer.start();
+
     double tempDesired = convertTemperature(currentDesiredTempC, currentTempUnit);
     QString tempTextDesired = QString("Температура: %1 %2").arg(tempDesired).arg(currentTempUnit);
     tempSelectLabel->setText(tempTextDesired);
@@ -226,6 +431,10 @@ void ControllerWidget::updateDisplay() {
         airflowLabel->setText(QString("Направление воздуха: В стороны"));
         break;
     }
+
+    syncUnitReadings();
+
+    MetricsRegistry::instance().observeDisplayDuration(timer.nsecsElapsed());
 }
 
 double ControllerWidget::convertTemperature(double temp, const QString &toUnit) {
@@ -241,11 +450,12 @@ double ControllerWidget::convertPressure(double pressure, const QString &toUnit)
 
 void ControllerWidget::toggleTheme() {
     theme = static_cast<Theme>(!static_cast<bool>(theme));
-    setStyleSheet(static_cast<bool>(theme) ? "background: #333; color: white;" : "");
+    themeEngine->apply(theme, this, scene);
 }
 
 void ControllerWidget::showSimulationDialog() {
     QDialog dialog(this);
+    dialog.setAttribute(Qt::WA_WindowPropagation);
     dialog.setWindowTitle("Имитация данных");
 
     QFormLayout *form = new QFormLayout(&dialog);
@@ -287,6 +497,16 @@ void ControllerWidget::showSimulationDialog() {
     QCheckBox *randomImitationBox = new QCheckBox(&dialog);
     form->addRow("Рандомная имитация:", randomImitationBox);
 
+    QSpinBox *fleetSpin = new QSpinBox(&dialog);
+    fleetSpin->setRange(0, 100000);
+    fleetSpin->setValue(unitTable->unitCount() - BLOCK_COUNT);
+    form->addRow("Дополнительные блоки:", fleetSpin);
+
+    QComboBox *policyCombo = new QComboBox(&dialog);
+    policyCombo->addItems({"Без ограничений", "Последнее значение", "Усреднение"});
+    policyCombo->setCurrentIndex(static_cast<int>(telemetry->policy()));
+    form->addRow("Обработка перегрузки:", policyCombo);
+
     if(controller == nullptr)
         randomImitationBox->setCheckState(Qt::CheckState::Unchecked);
     else randomImitationBox->setCheckState(Qt::CheckState::Checked);
@@ -298,16 +518,22 @@ void ControllerWidget::showSimulationDialog() {
     connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
 
     if (dialog.exec() == QDialog::Accepted) {
+        telemetry->setPolicy(static_cast<SheddingPolicy>(policyCombo->currentIndex()));
+
         if(randomImitationBox->isChecked()) {
             if(controller == nullptr) {
                 controller = new MockController(this);
-                controller->onTurnOn();
+                if (isSystemOn)
+                    controller->onTurnOn();
             }
+            controller->setFleetSize(fleetSpin->value());
         }
         else if(controller != nullptr) {
             controller->deleteLater();
             controller = nullptr;
+            unitTable->resize(BLOCK_COUNT);
         }
+        telemetry->flush();
 
         updateTemperature(tempSpin->value());
         updateHumidity(humiditySpin->value());
@@ -331,6 +557,7 @@ void ControllerWidget::saveSettings() {
     xml.writeTextElement("TemperatureUnit", currentTempUnit);
     xml.writeTextElement("PressureUnit", currentPressureUnit);
     xml.writeTextElement("Theme", theme == Theme::DARK ? "dark" : "light");
+    schedule->writeXml(xml);
     xml.writeEndElement();
     xml.writeEndDocument();
 }
@@ -351,34 +578,367 @@ void ControllerWidget::loadSettings() {
                 pressureUnitCombo->setCurrentIndex(currentPressureUnit == "mmHg" ? 1 : 0);
             } else if (xml.name() == QString("Theme") && xml.readElementText() == "dark") {
                 toggleTheme();
+            } else if (xml.name() == QString("Schedule")) {
+                schedule->readXml(xml);
             }
         }
     }
 }
 
 void ControllerWidget::setBlock1Status(BlockStatus status) {
+    MetricsRegistry::instance().countSlotUpdate(MetricsSlot::SET_BLOCK1_STATUS);
+    MetricsRegistry::instance().recordBlockStatus(0, status);
     updateBlockColor(block1, status);
+    syncUnitStatus(0, status);
 }
 
 void ControllerWidget::setBlock2Status(BlockStatus status) {
+    MetricsRegistry::instance().countSlotUpdate(MetricsSlot::SET_BLOCK2_STATUS);
+    MetricsRegistry::instance().recordBlockStatus(1, status);
     updateBlockColor(block2, status);
+    syncUnitStatus(1, status);
 }
 
 void ControllerWidget::setBlock3Status(BlockStatus status) {
+    MetricsRegistry::instance().countSlotUpdate(MetricsSlot::SET_BLOCK3_STATUS);
+    MetricsRegistry::instance().recordBlockStatus(2, status);
     updateBlockColor(block3, status);
+    syncUnitStatus(2, status);
 }
 
 void ControllerWidget::updateBlockColor(QGraphicsRectItem* block, BlockStatus status) {
-    switch(status) {
-    case BlockStatus::BLOCK_OFF:
-        block->setBrush(Qt::gray);
-        break;
-    case BlockStatus::BLOCK_ERROR:
-        block->setBrush(Qt::red);
-        break;
-    case BlockStatus::BLOCK_ON:
-        block->setBrush(Qt::green);
-        break;
+    block->setData(ThemeEngine::STATUS_KEY, static_cast<int>(status));
+    block->setBrush(themeEngine->blockBrush(status));
+}
+
+void ControllerWidget::showScheduleDialog() {
+    QDialog dialog(this);
+    dialog.setAttribute(Qt::WA_WindowPropagation);
+    dialog.setWindowTitle("Расписание");
+    dialog.resize(700, 500);
+
+    const QStringList dayNames = {"Пн", "Вт", "Ср", "Чт", "Пт", "Сб", "Вс"};
+    const QStringList actionNames = {"Включить", "Выключить", "Температура", "Направление"};
+    const QStringList airflowNames = {"Авто", "Вверх", "Вниз", "В стороны"};
+
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+
+    QTableWidget *table = new QTableWidget(&dialog);
+    table->setColumnCount(5);
+    table->setHorizontalHeaderLabels({"Блок", "Дни", "Время", "Действие", "Значение"});
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    layout->addWidget(table);
+
+    auto refresh = [&]() {
+        const QVector<int> ids = schedule->entryIds();
+        table->setRowCount(ids.size());
+        for (int row = 0; row < ids.size(); ++row) {
+            const ScheduleEntry &entry = schedule->entry(ids[row]);
+
+            QStringList days;
+            for (int day = 0; day < 7; ++day)
+                if (entry.days & (1 << day))
+                    days << dayNames[day];
+
+            QString value;
+            if (entry.action == ScheduleAction::SET_TEMPERATURE)
+                value = QString("%1 °C").arg(entry.value);
+            else if (entry.action == ScheduleAction::SET_AIRFLOW)
+                value = airflowNames.value(entry.value);
+
+            QTableWidgetItem *unitItem = new QTableWidgetItem(entry.unit < BLOCK_COUNT ? QString("Система")
+                                                                                       : QString::number(entry.unit + 1));
+            unitItem->setData(Qt::UserRole, ids[row]);
+            table->setItem(row, 0, unitItem);
+            table->setItem(row, 1, new QTableWidgetItem(days.join(' ')));
+            table->setItem(row, 2, new QTableWidgetItem(entry.time.toString("HH:mm")));
+            table->setItem(row, 3, new QTableWidgetItem(actionNames[static_cast<int>(entry.action)]));
+            table->setItem(row, 4, new QTableWidgetItem(value));
+        }
+    };
+    refresh();
+
+    QHBoxLayout *dayLayout = new QHBoxLayout();
+    QVector<QCheckBox *> dayBoxes;
+    for (int day = 0; day < 7; ++day) {
+        QCheckBox *box = new QCheckBox(dayNames[day], &dialog);
+        box->setChecked(day < 5);
+        dayBoxes.append(box);
+        dayLayout->addWidget(box);
+    }
+
+    QHBoxLayout *entryLayout = new QHBoxLayout();
+
+    // The blocks of the local system are switched together, so they are
+    // scheduled as one target shown at the bottom of the range.
+    QSpinBox *unitSpin = new QSpinBox(&dialog);
+    unitSpin->setRange(BLOCK_COUNT, 100000);
+    unitSpin->setPrefix("Блок ");
+    unitSpin->setSpecialValueText(QString("Система (блоки 1-%1)").arg(BLOCK_COUNT));
+
+    QTimeEdit *timeEdit = new QTimeEdit(QTime(8, 0), &dialog);
+    timeEdit->setDisplayFormat("HH:mm");
+
+    QComboBox *actionCombo = new QComboBox(&dialog);
+    actionCombo->addItems(actionNames);
+
+    QSpinBox *valueSpin = new QSpinBox(&dialog);
+    valueSpin->setRange(16, 30);
+    valueSpin->setValue(24);
+
+    QComboBox *airflowValueCombo = new QComboBox(&dialog);
+    airflowValueCombo->addItems(airflowNames);
+
+    entryLayout->addWidget(unitSpin);
+    entryLayout->addWidget(timeEdit);
+    entryLayout->addWidget(actionCombo);
+    entryLayout->addWidget(valueSpin);
+    entryLayout->addWidget(airflowValueCombo);
+
+    auto updateValueInputs = [=](int action) {
+        valueSpin->setVisible(action == static_cast<int>(ScheduleAction::SET_TEMPERATURE));
+        airflowValueCombo->setVisible(action == static_cast<int>(ScheduleAction::SET_AIRFLOW));
+    };
+    updateValueInputs(actionCombo->currentIndex());
+    connect(actionCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), &dialog, updateValueInputs);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    QPushButton *addButton = new QPushButton("Добавить", &dialog);
+    QPushButton *removeButton = new QPushButton("Удалить выбранные", &dialog);
+    QPushButton *closeButton = new QPushButton("Закрыть", &dialog);
+    buttonLayout->addWidget(addButton);
+    buttonLayout->addWidget(removeButton);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(closeButton);
+
+    layout->addLayout(dayLayout);
+    layout->addLayout(entryLayout);
+    layout->addLayout(buttonLayout);
+
+    connect(addButton, &QPushButton::clicked, &dialog, [&]() {
+        ScheduleEntry entry;
+        entry.unit = unitSpin->value() == BLOCK_COUNT ? 0 : unitSpin->value() - 1;
+        entry.days = 0;
+        for (int day = 0; day < 7; ++day)
+            if (dayBoxes[day]->isChecked())
+                entry.days |= 1 << day;
+        entry.time = timeEdit->time();
+        entry.action = static_cast<ScheduleAction>(actionCombo->currentIndex());
+        if (entry.action == ScheduleAction::SET_TEMPERATURE)
+            entry.value = valueSpin->value();
+        else if (entry.action == ScheduleAction::SET_AIRFLOW)
+            entry.value = airflowValueCombo->currentIndex();
+
+        schedule->addEntry(entry);
+        refresh();
+    });
+
+    connect(removeButton, &QPushButton::clicked, &dialog, [&]() {
+        for (const QModelIndex &index : table->selectionModel()->selectedRows())
+            schedule->removeEntry(table->item(index.row(), 0)->data(Qt::UserRole).toInt());
+        refresh();
+    });
+
+    connect(closeButton, &QPushButton::clicked, &dialog, &QDialog::accept);
+
+    dialog.exec();
+    saveSettings();
+}
+
+void ControllerWidget::applyScheduledCommands(const QVector<ScheduledCommand> &commands) {
+    // The blocks share one power state and one set of settings, so entries
+    // for the local system that fall due together collapse to the last one
+    // of each kind instead of undoing each other.
+    QVector<ScheduledCommand> remote;
+    bool power = false, powerOn = false, temperature = false, airflow = false;
+    int temperatureValue = 0, airflowValue = 0;
+    for (const ScheduledCommand &command : commands) {
+        if (command.unit >= BLOCK_COUNT) {
+            remote.append(command);
+            continue;
+        }
+
+        switch (command.action) {
+        case ScheduleAction::TURN_ON:
+        case ScheduleAction::TURN_OFF:
+            power = true;
+            powerOn = command.action == ScheduleAction::TURN_ON;
+            break;
+        case ScheduleAction::SET_TEMPERATURE:
+            temperature = true;
+            temperatureValue = command.value;
+            break;
+        case ScheduleAction::SET_AIRFLOW:
+            airflow = true;
+            airflowValue = command.value;
+            break;
+        }
+    }
+
+    // Power first, so settings due at the same time wait for it.
+    if (power)
+        applyScheduledPower(powerOn);
+    if (temperature)
+        applyScheduledSetting(ScheduleAction::SET_TEMPERATURE, temperatureValue);
+    if (airflow)
+        applyScheduledSetting(ScheduleAction::SET_AIRFLOW, airflowValue);
+
+    if (!remote.isEmpty())
+        sendScheduledCommands(std::move(remote));
+}
+
+CommandTask ControllerWidget::sendScheduledCommands(QVector<ScheduledCommand> batch) {
+    // Everything is sent before the first answer is awaited, so the controllers work on the batch in parallel.
+    std::vector<CommandAwaiter> answers;
+    answers.reserve(batch.size());
+    for (const ScheduledCommand &command : batch)
+        answers.push_back(commands->send(command.unit, command.action, command.value));
+
+    int failed = 0;
+    CommandOutcome firstFailure = CommandOutcome::ACKNOWLEDGED;
+    for (CommandAwaiter &answer : answers) {
+        const CommandResult result = co_await answer;
+        if (result.outcome == CommandOutcome::ACKNOWLEDGED)
+            continue;
+        if (failed++ == 0)
+            firstFailure = result.outcome;
+    }
+
+    if (failed > 0)
+        reportCommandFailure(QString("Расписание, %1 из %2 команд").arg(failed).arg(batch.size()), firstFailure);
+}
+
+UnitTableModel *ControllerWidget::unitModel() const {
+    return unitTable;
+}
+
+TelemetryThrottle *ControllerWidget::telemetryInput() const {
+    return telemetry;
+}
+
+CommandChannel *ControllerWidget::commandChannel() const {
+    return commands;
+}
+
+void ControllerWidget::setSharedFeed(SharedFeedMode mode, int fleetSize) {
+    if (mode == SharedFeedMode::WRITER) {
+        if (controller == nullptr)
+            controller = new MockController(this);
+        controller->setFleetSize(fleetSize);
+        if (!isSystemOn) {
+            powerButton->setChecked(true);
+            toggleSystem();
+        }
+        if (sharedWriter == nullptr)
+            sharedWriter = new SharedStateWriter(unitTable, this);
+    }
+    else if (mode == SharedFeedMode::READER) {
+        if (sharedReader == nullptr)
+            sharedReader = new SharedStateReader(this, this);
+    }
+}
+
+void ControllerWidget::showUnitList() {
+    if (unitList == nullptr)
+        unitList = new UnitListWidget(unitTable, this);
+        unitList->setAttribute(Qt::WA_WindowPropagation);
+    unitList->show();
+    unitList->raise();
+    unitList->activateWindow();
+}
+
+void ControllerWidget::syncUnitReadings() {
+    for (int i = 0; i < BLOCK_COUNT; ++i) {
+        UnitState state = unitTable->unit(i);
+        state.temperatureC = currentTempC;
+        state.setpointC = currentDesiredTempC;
+        state.humidity = currentHumidity;
+        state.pressurePa = currentPressurePa;
+        state.airflow = currentAirflowSetting;
+        unitTable->setUnit(i, state);
+    }
+}
+
+void ControllerWidget::syncUnitStatus(int index, BlockStatus status) {
+    UnitState state = unitTable->unit(index);
+    state.status = status;
+    unitTable->setUnit(index, state);
+}
+
+qint64 ControllerWidget::historyTimestamp() const {
+    return historyEpochMs + historyClock.elapsed();
+}
+
+void ControllerWidget::maintainHistory() {
+    const qint64 now = historyTimestamp();
+    const qint64 day = 24LL * 3600 * 1000;
+    temperatureHistory.dropBefore(now - HISTORY_RETENTION_DAYS * day);
+    humidityHistory.dropBefore(now - HISTORY_RETENTION_DAYS * day);
+    pressureHistory.dropBefore(now - HISTORY_RETENTION_DAYS * day);
+
+    const qint64 from = now - HISTORY_SUMMARY_HOURS * 3600LL * 1000;
+    double minValue, maxValue;
+    if (temperatureHistory.minMax(from, now, minValue, maxValue))
+        tempLabel->setToolTip(QString("За %1 ч: мин. %2 %4, макс. %3 %4").arg(HISTORY_SUMMARY_HOURS)
+                                  .arg(convertTemperature(minValue, currentTempUnit), 0, 'f', 1)
+                                  .arg(convertTemperature(maxValue, currentTempUnit), 0, 'f', 1).arg(currentTempUnit));
+    if (humidityHistory.minMax(from, now, minValue, maxValue))
+        humidityLabel->setToolTip(QString("За %1 ч: мин. %2 %, макс. %3 %").arg(HISTORY_SUMMARY_HOURS)
+                                      .arg(minValue, 0, 'f', 1).arg(maxValue, 0, 'f', 1));
+    if (pressureHistory.minMax(from, now, minValue, maxValue))
+        pressureLabel->setToolTip(QString("За %1 ч: мин. %2 %4, макс. %3 %4").arg(HISTORY_SUMMARY_HOURS)
+                                      .arg(convertPressure(minValue, currentPressureUnit), 0, 'f', 0)
+                                      .arg(convertPressure(maxValue, currentPressureUnit), 0, 'f', 0).arg(currentPressureUnit));
+}
+
+void ControllerWidget::createEnergyPanel() {
+    energyGroup = new QGroupBox("Энергопотребление", this);
+    QGridLayout *grid = new QGridLayout(energyGroup);
+
+    const QStringList columns = {"кВт·ч", "Ср. мощность, Вт", "Работа, ч", "Ошибка, ч", "Откл., °C", "Комфорт, ч/кВт·ч"};
+    for (int column = 0; column < columns.size(); ++column)
+        grid->addWidget(new QLabel(columns[column], energyGroup), 0, column + 1);
+
+    for (int row = 0; row <= BLOCK_COUNT; ++row) {
+        const QString name = row < BLOCK_COUNT ? QString("Блок %1").arg(row + 1) : QString("Все блоки");
+        grid->addWidget(new QLabel(name, energyGroup), row + 1, 0);
+        for (int column = 0; column < columns.size(); ++column) {
+            QLabel *cell = new QLabel("—", energyGroup);
+            cell->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            grid->addWidget(cell, row + 1, column + 1);
+            energyCells.append(cell);
+        }
+    }
+}
+
+void ControllerWidget::recordEnergySample() {
+    for (int i = 0; i < BLOCK_COUNT; ++i) {
+        const UnitState &state = unitTable->unit(i);
+        EnergyHistory &history = energyHistory[i];
+        history.append(static_cast<float>(state.setpointC), static_cast<float>(state.temperatureC),
+                       static_cast<float>(state.humidity), state.airflow, state.status);
+        // Trim a day at a time rather than shifting the columns on every sample.
+        if (history.size() > ENERGY_RETENTION_SAMPLES + 24 * 3600 / ENERGY_SAMPLE_INTERVAL_SEC)
+            history.keepLatest(ENERGY_RETENTION_SAMPLES);
+    }
+    refreshEnergyPanel();
+}
+
+void ControllerWidget::refreshEnergyPanel() {
+    std::vector<EnergySummary> perBlock;
+    const EnergySummary total = analyzeEnergy(energyHistory, EnergyModel(), perBlock);
+    perBlock.push_back(total);
+
+    const int columns = energyCells.size() / (BLOCK_COUNT + 1);
+    for (int row = 0; row < static_cast<int>(perBlock.size()); ++row) {
+        const EnergySummary &summary = perBlock[row];
+        const double values[] = {summary.energyKWh, summary.averagePowerW(), summary.onHours,
+                                 summary.errorHours, summary.meanAbsErrorC(), summary.comfortHoursPerKWh()};
+        const int decimals[] = {2, 0, 1, 1, 2, 2};
+        for (int column = 0; column < columns; ++column)
+            energyCells[row * columns + column]->setText(QString::number(values[column], 'f', decimals[column]));
     }
 }
 
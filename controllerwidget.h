@@ -25,6 +25,13 @@
 #include <QXmlStreamReader>
 #include <QFormLayout>
 #include <QCheckBox>
+#include <QGridLayout>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <vector>
+#include "sensorhistory.h"
+#include "scheduleengine.h"
+#include "commandchannel.h"
 
 /**
  * @enum BlockStatus
@@ -62,6 +69,54 @@ enum class Theme : bool {
  */
 class MockController;
 
+/**
+ * @class UnitTableModel
+ * @brief Forward declaration of the model holding the state of all units.
+ */
+class UnitTableModel;
+
+/**
+ * @class UnitListWidget
+ * @brief Forward declaration of the unit table window.
+ */
+class UnitListWidget;
+
+/**
+ * @class TelemetryThrottle
+ * @brief Forward declaration of the load-shedding buffer for backend updates.
+ */
+class TelemetryThrottle;
+
+/**
+ * @class ThemeEngine
+ * @brief Forward declaration of the palette-based theme switcher.
+ */
+class ThemeEngine;
+
+/**
+ * @class SharedStateWriter
+ * @brief Forward declaration of the shared-memory table writer.
+ */
+class SharedStateWriter;
+
+/**
+ * @class SharedStateReader
+ * @brief Forward declaration of the shared-memory table reader.
+ */
+class SharedStateReader;
+
+/**
+ * @class EnergyHistory
+ * @brief Forward declaration of the columnar history used for energy estimates.
+ */
+class EnergyHistory;
+
+/**
+ * @enum SharedFeedMode
+ * @brief Forward declaration of how a console obtains unit state.
+ */
+enum class SharedFeedMode;
+
 /**
  * @class ControllerWidget
  * @brief A QWidget that simulates and controls an air conditioning system UI.
@@ -70,6 +125,31 @@ class ControllerWidget : public QWidget {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Number of blocks shown in the graphics scene. They occupy the first rows of the unit model.
+     */
+    static constexpr int BLOCK_COUNT = 3;
+
+    /**
+     * @brief Number of days of sensor history kept.
+     */
+    static constexpr int HISTORY_RETENTION_DAYS = 30;
+
+    /**
+     * @brief Period summarized in the tooltips of the reading labels, in hours.
+     */
+    static constexpr int HISTORY_SUMMARY_HOURS = 24;
+
+    /**
+     * @brief Interval between energy history samples, in seconds.
+     */
+    static constexpr int ENERGY_SAMPLE_INTERVAL_SEC = 60;
+
+    /**
+     * @brief Number of energy history samples kept per block, 31 days at one per minute.
+     */
+    static constexpr int ENERGY_RETENTION_SAMPLES = 31 * 24 * 60;
+
     /**
      * @brief Constructor for ControllerWidget.
      * @param parent Parent QWidget.
@@ -81,25 +161,51 @@ public:
      */
     ~ControllerWidget();
 
+    /**
+     * @brief Returns the model holding the state of all units.
+     */
+    UnitTableModel *unitModel() const;
+
+    /**
+     * @brief Returns the buffer backends should submit their updates to.
+     */
+    TelemetryThrottle *telemetryInput() const;
+
+    /**
+     * @brief Returns the channel controllers receive commands from.
+     */
+    CommandChannel *commandChannel() const;
+
+    /**
+     * @brief Connects the console to the shared state table.
+     *
+     * A writer starts the simulation and publishes every unit; a reader
+     * displays what the writer publishes instead of running its own backend.
+     *
+     * @param mode Feed mode.
+     * @param fleetSize Number of additional units simulated by a writer.
+     */
+    void setSharedFeed(SharedFeedMode mode, int fleetSize);
+
 signals:
     /**
-     * @brief Emitted when the system is turned on.
+     * @brief Emitted when the controller has acknowledged turning the system on.
      */
     void turnOnRequest();
 
     /**
-     * @brief Emitted when the system is turned off.
+     * @brief Emitted when the controller has acknowledged turning the system off.
      */
     void turnOffRequest();
 
     /**
-     * @brief Emitted when the user changes the desired airflow.
+     * @brief Emitted when the controller has acknowledged a new airflow direction.
      * @param dir The new airflow direction.
      */
     void desiredAirFlowChanged(AirFlowDirection dir);
 
     /**
-     * @brief Emitted when the user changes the desired temperature.
+     * @brief Emitted when the controller has acknowledged a new desired temperature.
      * @param value New temperature in Celsius.
      */
     void desiredTemperatureChanged(int value);
@@ -150,16 +256,21 @@ public slots:
 private slots:
 private slots:
     /**
-     * @brief Toggles the system on or off when the power button is clicked.
+     * @brief Turns the system on or off to match the power button once the controller acknowledges it.
      */
     void toggleSystem();
 
     /**
-     * @brief Called when the temperature slider changes.
+     * @brief Called when the temperature slider changes. Shows the value and schedules sending it.
      * @param value Desired temperature in Celsius.
      */
     void updateTemperatureRequest(int value);
 
+    /**
+     * @brief Sends the temperature slider value once it has settled.
+     */
+    void sendTemperatureRequest();
+
     /**
      * @brief Called when the airflow direction combo box changes.
      * @param index Index corresponding to AirFlowDirection.
@@ -188,6 +299,22 @@ private slots:
      */
     void showSimulationDialog();
 
+    /**
+     * @brief Shows the window with the table of all units.
+     */
+    void showUnitList();
+
+    /**
+     * @brief Opens a dialog for editing the weekly schedule.
+     */
+    void showScheduleDialog();
+
+    /**
+     * @brief Applies scheduled commands addressed to the local system and sends the others to their controllers.
+     * @param commands Commands that fell due.
+     */
+    void applyScheduledCommands(const QVector<ScheduledCommand> &commands);
+
     /**
      * @brief Saves user settings (theme, units) to an XML file.
      */
@@ -198,6 +325,16 @@ private slots:
      */
     void loadSettings();
 
+    /**
+     * @brief Appends the current state of every block to the energy history and refreshes the energy panel.
+     */
+    void recordEnergySample();
+
+    /**
+     * @brief Drops sensor history older than HISTORY_RETENTION_DAYS and refreshes the reading tooltips.
+     */
+    void maintainHistory();
+
 private:
     /**
      * @brief Scene that contains graphical block representations.
@@ -222,7 +359,7 @@ private:
     /**
      * @brief Buttons for power toggle, theme switching, and simulation dialog.
      */
-    QPushButton *powerButton, *themeButton, *simulateButton;
+    QPushButton *powerButton, *themeButton, *simulateButton, *unitListButton, *scheduleButton;
 
     /**
      * @brief Slider for adjusting desired temperature.
@@ -274,6 +411,26 @@ private:
      */
     AirFlowDirection currentAirflowSetting = AirFlowDirection::AUTO;
 
+    /**
+     * @brief Compressed history of the temperature, humidity and pressure readings.
+     */
+    HistorySeries temperatureHistory, humidityHistory, pressureHistory;
+
+    /**
+     * @brief Monotonic clock for history timestamps, so wall-clock corrections cannot reorder samples.
+     */
+    QElapsedTimer historyClock;
+
+    /**
+     * @brief Wall-clock time in milliseconds since the Unix epoch at which historyClock was started.
+     */
+    qint64 historyEpochMs = 0;
+
+    /**
+     * @brief Drives maintainHistory().
+     */
+    QTimer *historyTimer = nullptr;
+
     /**
      * @brief Selected unit for temperature display ("C", "F", or "K").
      */
@@ -289,6 +446,187 @@ private:
      */
     MockController* controller = nullptr;
 
+    /**
+     * @brief Model holding the state of the blocks and of any simulated units.
+     */
+    UnitTableModel *unitTable = nullptr;
+
+    /**
+     * @brief Window with the table of all units, created on first use.
+     */
+    UnitListWidget *unitList = nullptr;
+
+    /**
+     * @brief Buffer applying backend updates at most once per frame.
+     */
+    TelemetryThrottle *telemetry = nullptr;
+
+    /**
+     * @brief Weekly schedule, saved with the other settings.
+     */
+    ScheduleEngine *schedule = nullptr;
+
+    /**
+     * @brief Precomputed palettes and scene brushes for both themes.
+     */
+    ThemeEngine *themeEngine = nullptr;
+
+    /**
+     * @brief Commands sent to the controllers.
+     */
+    CommandChannel *commands = nullptr;
+
+    /**
+     * @brief Whether a power command is waiting for its acknowledgement.
+     */
+    bool powerCommandPending = false;
+
+    /**
+     * @brief Delays sending the temperature so a slider drag becomes a single command.
+     */
+    QTimer *temperatureSendTimer = nullptr;
+
+    /**
+     * @brief Last desired temperature the controller acknowledged, in Celsius.
+     */
+    int acknowledgedTemperature = 0;
+
+    /**
+     * @brief Last airflow direction the controller acknowledged.
+     */
+    AirFlowDirection acknowledgedAirflow = AirFlowDirection::AUTO;
+
+    /**
+     * @brief Number of temperature commands sent; only the answer to the latest one is applied.
+     */
+    quint64 temperatureSerial = 0;
+
+    /**
+     * @brief Number of airflow commands sent; only the answer to the latest one is applied.
+     */
+    quint64 airflowSerial = 0;
+
+    /**
+     * @brief Whether a scheduled power command arrived while another one was pending.
+     */
+    bool scheduledPowerDeferred = false;
+
+    /**
+     * @brief Power state requested by the deferred scheduled command.
+     */
+    bool scheduledPowerOn = false;
+
+    /**
+     * @brief Whether a scheduled temperature waits for the system to be on.
+     */
+    bool scheduledTemperatureDeferred = false;
+
+    /**
+     * @brief Deferred scheduled temperature in Celsius.
+     */
+    int scheduledTemperature = 0;
+
+    /**
+     * @brief Whether a scheduled airflow direction waits for the system to be on.
+     */
+    bool scheduledAirflowDeferred = false;
+
+    /**
+     * @brief Deferred scheduled AirFlowDirection index.
+     */
+    int scheduledAirflow = 0;
+
+    /**
+     * @brief Publishes the unit model to other consoles, if this console is the writer.
+     */
+    SharedStateWriter *sharedWriter = nullptr;
+
+    /**
+     * @brief Feeds this console from the shared table, if it is a reader.
+     */
+    SharedStateReader *sharedReader = nullptr;
+
+    /**
+     * @brief Recorded history of every block, used for the energy panel.
+     */
+    std::vector<EnergyHistory> energyHistory;
+
+    /**
+     * @brief Drives recordEnergySample().
+     */
+    QTimer *energyTimer = nullptr;
+
+    /**
+     * @brief Panel with the energy estimates.
+     */
+    QGroupBox *energyGroup = nullptr;
+
+    /**
+     * @brief Value cells of the energy panel, row by row: one row per block, then the totals.
+     */
+    QVector<QLabel *> energyCells;
+
+    /**
+     * @brief Sends a power command and applies the new state once it is acknowledged.
+     * @param on Whether to turn the system on.
+     */
+    CommandTask switchSystem(bool on);
+
+    /**
+     * @brief Switches the system for the schedule, deferring the switch while a power command is pending.
+     * @param on Whether to turn the system on.
+     */
+    void applyScheduledPower(bool on);
+
+    /**
+     * @brief Changes a setting for the schedule, deferring the change until the system is on and no power command is pending.
+     * @param action SET_TEMPERATURE or SET_AIRFLOW.
+     * @param value Temperature in Celsius or AirFlowDirection index.
+     */
+    void applyScheduledSetting(ScheduleAction action, int value);
+
+    /**
+     * @brief Applies scheduled settings that were deferred, if the system can now take them.
+     */
+    void applyDeferredSettings();
+
+    /**
+     * @brief Sends a setting change to the controller.
+     *
+     * Once the latest command for the setting is acknowledged, the value
+     * becomes the acknowledged one; if it fails, the control returns to the
+     * last acknowledged value and the failure is reported. Answers to
+     * commands superseded meanwhile are ignored.
+     *
+     * @param action SET_TEMPERATURE or SET_AIRFLOW.
+     * @param value Temperature in Celsius or AirFlowDirection index.
+     */
+    CommandTask sendSetting(ScheduleAction action, int value);
+
+    /**
+     * @brief Sends scheduled commands for units beyond the blocks, all at once, and reports any that fail.
+     * @param batch Commands to send, taken by value because the coroutine outlives the caller's batch.
+     */
+    CommandTask sendScheduledCommands(QVector<ScheduledCommand> batch);
+
+    /**
+     * @brief Returns a setting control to its last acknowledged value without sending a command.
+     * @param action SET_TEMPERATURE or SET_AIRFLOW.
+     */
+    void revertSetting(ScheduleAction action);
+
+    /**
+     * @brief Enables the controls and labels the power button according to isSystemOn.
+     */
+    void applyPowerState();
+
+    /**
+     * @brief Shows a non-blocking warning about a command that was not applied.
+     * @param what Description of the command.
+     * @param outcome How the command ended.
+     */
+    void reportCommandFailure(const QString &what, CommandOutcome outcome);
+
     /**
      * @brief Updates all display labels to reflect the current state.
      */
@@ -316,6 +654,33 @@ private:
      * @param status The new block status.
      */
     void updateBlockColor(QGraphicsRectItem* block, BlockStatus status);
+
+    /**
+     * @brief Copies the current readings into the unit model rows of the blocks.
+     */
+    void syncUnitReadings();
+
+    /**
+     * @brief Updates the status of a block in the unit model.
+     * @param index Block index.
+     * @param status The new block status.
+     */
+    void syncUnitStatus(int index, BlockStatus status);
+
+    /**
+     * @brief Returns the timestamp for a new history sample, in milliseconds since the Unix epoch.
+     */
+    qint64 historyTimestamp() const;
+
+    /**
+     * @brief Creates the energy panel.
+     */
+    void createEnergyPanel();
+
+    /**
+     * @brief Recomputes the estimates from the energy history and shows them in the energy panel.
+     */
+    void refreshEnergyPanel();
 };
 
 #endif // CONTROLLERWIDGET_H
@@ -0,0 +1,237 @@
+#include "energyanalytics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const int lanes = 8;
+const int blockSamples = 2048;
+
+/**
+ * @struct SampleBlock
+ * @brief Per-sample results of one block, small enough to stay in cache.
+ */
+struct SampleBlock {
+    float power[blockSamples];    ///< Estimated draw in Watts.
+    float on[blockSamples];       ///< 1 while running, else 0.
+    float error[blockSamples];    ///< 1 while in error, else 0.
+    float comfort[blockSamples];  ///< 1 while running within the comfort band, else 0.
+    float absError[blockSamples]; ///< |setpoint - actual| while running, else 0.
+};
+
+// The kernel decodes statuses and airflow modes with bit operations instead
+// of comparisons, which would turn into branches in the vectorized loop.
+static_assert(static_cast<int>(BlockStatus::BLOCK_OFF) == 0 && static_cast<int>(BlockStatus::BLOCK_ERROR) == 1
+                  && static_cast<int>(BlockStatus::BLOCK_ON) == 2,
+              "estimateBlock() decodes BlockStatus as bits");
+static_assert(static_cast<int>(AirFlowDirection::AUTO) == 0 && static_cast<int>(AirFlowDirection::SIDEWAYS) == 3,
+              "estimateBlock() decodes AirFlowDirection as bits");
+
+/**
+ * @brief Estimates every sample of a block.
+ *
+ * A plain element-wise loop without branches or reductions, which compilers
+ * vectorize in optimized builds.
+ */
+void estimateBlock(const EnergyHistory &history, const EnergyModel &model, qint64 begin, int count, SampleBlock &block) {
+    const float *setpoint = history.setpoint.data() + begin;
+    const float *actual = history.actual.data() + begin;
+    const float *humidity = history.humidity.data() + begin;
+    const quint8 *airflow = history.airflow.data() + begin;
+    const quint8 *status = history.status.data() + begin;
+
+    // Copies, because the stores into block might otherwise alias model.
+    const float basePowerW = model.basePowerW;
+    const float loadPowerWPerDeg = model.loadPowerWPerDeg;
+    const float latentPowerWPerPercent = model.latentPowerWPerPercent;
+    const float latentThresholdPercent = model.latentThresholdPercent;
+    const float fanAutoW = model.fanAutoW;
+    const float directedExtraW = model.fanDirectedW - model.fanAutoW;
+    const float sidewaysExtraW = model.fanSidewaysW - model.fanDirectedW;
+    const float errorStandbyW = model.errorStandbyW;
+    const float comfortBandC = model.comfortBandC;
+
+    for (int i = 0; i < count; ++i) {
+        const int state = status[i];
+        const int mode = airflow[i];
+        const int running = state >> 1;
+        const float on = static_cast<float>(running);
+        const float error = static_cast<float>(state & 1);
+        const float directed = static_cast<float>((mode | (mode >> 1)) & 1);
+        const float sideways = static_cast<float>(mode & (mode >> 1) & 1);
+
+        const float gap = std::fabs(setpoint[i] - actual[i]);
+        const float excess = humidity[i] - latentThresholdPercent;
+        const float latent = (excess + std::fabs(excess)) * 0.5f;
+        const float fan = fanAutoW + directedExtraW * directed + sidewaysExtraW * sideways;
+
+        // Clamped at zero like latent, so negative coefficients cannot produce
+        // the negative draws that blockMax() does not order correctly.
+        const float power = on * (basePowerW + loadPowerWPerDeg * gap + latentPowerWPerPercent * latent + fan)
+                            + error * errorStandbyW;
+        block.power[i] = (power + std::fabs(power)) * 0.5f;
+        block.on[i] = on;
+        block.error[i] = error;
+        block.comfort[i] = static_cast<float>(running & static_cast<int>(gap <= comfortBandC));
+        block.absError[i] = on * gap;
+    }
+}
+
+/**
+ * @brief Sums a block column in independent lanes so the additions vectorize
+ * without reordering a single floating-point sum.
+ * @param values Column of a SampleBlock.
+ * @param count Number of valid values, a multiple of lanes.
+ */
+double blockSum(const float *values, int count) {
+    float sums[lanes] = {};
+    for (int i = 0; i < count; i += lanes)
+        for (int lane = 0; lane < lanes; ++lane)
+            sums[lane] += values[i + lane];
+
+    double sum = 0.0;
+    for (float value : sums)
+        sum += value;
+    return sum;
+}
+
+/**
+ * @brief Returns the largest value of a block column.
+ *
+ * Non-negative floats order like their bit patterns read as integers, and
+ * integer maxima vectorize where floating-point comparisons do not.
+ *
+ * @param values Column of a SampleBlock, all values non-negative and not NaN,
+ * which estimateBlock() guarantees for finite model coefficients.
+ * @param count Number of valid values, a multiple of lanes.
+ */
+float blockMax(const float *values, int count) {
+    qint32 peaks[lanes] = {};
+    for (int i = 0; i < count; i += lanes) {
+        for (int lane = 0; lane < lanes; ++lane) {
+            qint32 bits;
+            std::memcpy(&bits, values + i + lane, sizeof(bits));
+            peaks[lane] = std::max(peaks[lane], bits);
+        }
+    }
+
+    const qint32 peak = *std::max_element(peaks, peaks + lanes);
+    float value;
+    std::memcpy(&value, &peak, sizeof(value));
+    return value;
+}
+
+}
+
+void EnergyHistory::append(float setpointC, float actualC, float humidityPercent, AirFlowDirection direction, BlockStatus blockStatus) {
+    setpoint.push_back(setpointC);
+    actual.push_back(actualC);
+    humidity.push_back(humidityPercent);
+    airflow.push_back(static_cast<quint8>(direction));
+    status.push_back(static_cast<quint8>(blockStatus));
+}
+
+void EnergyHistory::keepLatest(qint64 count) {
+    const qint64 excess = size() - count;
+    if (excess <= 0)
+        return;
+
+    setpoint.erase(setpoint.begin(), setpoint.begin() + excess);
+    actual.erase(actual.begin(), actual.begin() + excess);
+    humidity.erase(humidity.begin(), humidity.begin() + excess);
+    airflow.erase(airflow.begin(), airflow.begin() + excess);
+    status.erase(status.begin(), status.begin() + excess);
+}
+
+void EnergyHistory::reserve(qint64 count) {
+    setpoint.reserve(count);
+    actual.reserve(count);
+    humidity.reserve(count);
+    airflow.reserve(count);
+    status.reserve(count);
+}
+
+void EnergyHistory::clear() {
+    setpoint.clear();
+    actual.clear();
+    humidity.clear();
+    airflow.clear();
+    status.clear();
+}
+
+double EnergySummary::averagePowerW() const {
+    const double hours = onHours + errorHours + offHours;
+    return hours > 0.0 ? energyKWh * 1000.0 / hours : 0.0;
+}
+
+double EnergySummary::meanAbsErrorC() const {
+    return onHours > 0.0 ? absErrorDegHours / onHours : 0.0;
+}
+
+double EnergySummary::comfortHoursPerKWh() const {
+    return energyKWh > 0.0 ? comfortHours / energyKWh : 0.0;
+}
+
+void EnergySummary::merge(const EnergySummary &other) {
+    samples += other.samples;
+    energyKWh += other.energyKWh;
+    onHours += other.onHours;
+    errorHours += other.errorHours;
+    offHours += other.offHours;
+    comfortHours += other.comfortHours;
+    absErrorDegHours += other.absErrorDegHours;
+    peakPowerW = std::max(peakPowerW, other.peakPowerW);
+}
+
+EnergySummary analyzeEnergy(const EnergyHistory &history, const EnergyModel &model) {
+    Q_ASSERT(std::isfinite(model.basePowerW) && std::isfinite(model.loadPowerWPerDeg)
+             && std::isfinite(model.latentPowerWPerPercent) && std::isfinite(model.latentThresholdPercent)
+             && std::isfinite(model.fanAutoW) && std::isfinite(model.fanDirectedW) && std::isfinite(model.fanSidewaysW)
+             && std::isfinite(model.errorStandbyW) && std::isfinite(model.comfortBandC));
+    const qint64 count = history.size();
+    double power = 0.0, on = 0.0, error = 0.0, comfort = 0.0, absError = 0.0;
+    float peak = 0.0f;
+
+    thread_local SampleBlock block;
+    for (qint64 begin = 0; begin < count; begin += blockSamples) {
+        const int samples = static_cast<int>(std::min<qint64>(blockSamples, count - begin));
+        estimateBlock(history, model, begin, samples, block);
+
+        // Pad the last block to whole lanes with samples that add nothing.
+        const int padded = (samples + lanes - 1) / lanes * lanes;
+        for (float *column : {block.power, block.on, block.error, block.comfort, block.absError})
+            std::fill(column + samples, column + padded, 0.0f);
+
+        power += blockSum(block.power, padded);
+        on += blockSum(block.on, padded);
+        error += blockSum(block.error, padded);
+        comfort += blockSum(block.comfort, padded);
+        absError += blockSum(block.absError, padded);
+        peak = std::max(peak, blockMax(block.power, padded));
+    }
+
+    const double hoursPerSample = history.intervalSec() / 3600.0;
+    EnergySummary summary;
+    summary.samples = count;
+    summary.energyKWh = power * hoursPerSample / 1000.0;
+    summary.onHours = on * hoursPerSample;
+    summary.errorHours = error * hoursPerSample;
+    summary.offHours = (count - on - error) * hoursPerSample;
+    summary.comfortHours = comfort * hoursPerSample;
+    summary.absErrorDegHours = absError * hoursPerSample;
+    summary.peakPowerW = peak;
+    return summary;
+}
+
+EnergySummary analyzeEnergy(const std::vector<EnergyHistory> &histories, const EnergyModel &model,
+                            std::vector<EnergySummary> &perUnit) {
+    EnergySummary total;
+    perUnit.resize(histories.size());
+    for (size_t unit = 0; unit < histories.size(); ++unit) {
+        perUnit[unit] = analyzeEnergy(histories[unit], model);
+        total.merge(perUnit[unit]);
+    }
+    return total;
+}
@@ -0,0 +1,154 @@
+#ifndef ENERGYANALYTICS_H
+#define ENERGYANALYTICS_H
+
+/**
+ * @file energyanalytics.h
+ * @brief Defines energy and efficiency estimates computed over recorded unit history.
+ *
+ * History is stored column by column so the kernels stream through plain
+ * arrays. Samples are estimated block by block in a loop without
+ * data-dependent branches, and the block results are summed in independent
+ * lanes, so the compiler vectorizes both steps without intrinsics or relaxed
+ * floating-point flags.
+ */
+
+#include <QtGlobal>
+#include <vector>
+#include "controllerwidget.h"
+
+/**
+ * @struct EnergyModel
+ * @brief Coefficients of the power draw estimate.
+ *
+ * A running unit draws basePowerW, plus loadPowerWPerDeg for every degree
+ * between setpoint and actual temperature, plus latentPowerWPerPercent for
+ * every percent of humidity above latentThresholdPercent, plus fan power
+ * for its airflow mode. A unit in error draws errorStandbyW. A unit that is
+ * off draws nothing. Coefficients must be finite; an estimate that comes out
+ * negative counts as zero.
+ */
+struct EnergyModel {
+    float basePowerW = 600.0f;            ///< Compressor draw at zero temperature difference.
+    float loadPowerWPerDeg = 250.0f;      ///< Extra draw per degree Celsius of difference.
+    float latentPowerWPerPercent = 8.0f;  ///< Extra draw per percent of humidity above the threshold.
+    float latentThresholdPercent = 50.0f; ///< Humidity below which no dehumidification load is added.
+    float fanAutoW = 60.0f;               ///< Fan draw in AirFlowDirection::AUTO.
+    float fanDirectedW = 80.0f;           ///< Fan draw in AirFlowDirection::UP and DOWN.
+    float fanSidewaysW = 100.0f;          ///< Fan draw in AirFlowDirection::SIDEWAYS.
+    float errorStandbyW = 40.0f;          ///< Draw of a unit in the error state.
+    float comfortBandC = 1.0f;            ///< Largest difference from the setpoint counted as comfortable.
+};
+
+/**
+ * @class EnergyHistory
+ * @brief Columnar history of one unit, sampled at a fixed interval.
+ */
+class EnergyHistory {
+public:
+    /**
+     * @brief Constructor.
+     * @param intervalSec Time represented by each sample, in seconds.
+     */
+    explicit EnergyHistory(float intervalSec = 60.0f) : interval(intervalSec) {}
+
+    /**
+     * @brief Appends a sample.
+     * @param setpointC Desired temperature in Celsius.
+     * @param actualC Actual temperature in Celsius.
+     * @param humidityPercent Relative humidity percentage.
+     * @param direction Airflow direction.
+     * @param blockStatus Block status.
+     */
+    void append(float setpointC, float actualC, float humidityPercent, AirFlowDirection direction, BlockStatus blockStatus);
+
+    /**
+     * @brief Drops the oldest samples so that at most a number of samples remain.
+     * @param count Number of samples to keep.
+     */
+    void keepLatest(qint64 count);
+
+    /**
+     * @brief Reserves room for a number of samples.
+     * @param count Number of samples.
+     */
+    void reserve(qint64 count);
+
+    /**
+     * @brief Removes all samples.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the number of samples.
+     */
+    qint64 size() const { return static_cast<qint64>(status.size()); }
+
+    /**
+     * @brief Returns the time represented by each sample, in seconds.
+     */
+    float intervalSec() const { return interval; }
+
+    std::vector<float> setpoint;  ///< Desired temperature in Celsius.
+    std::vector<float> actual;    ///< Actual temperature in Celsius.
+    std::vector<float> humidity;  ///< Relative humidity percentage.
+    std::vector<quint8> airflow;  ///< AirFlowDirection index.
+    std::vector<quint8> status;   ///< BlockStatus index.
+
+private:
+    float interval; ///< Time represented by each sample, in seconds.
+};
+
+/**
+ * @struct EnergySummary
+ * @brief Aggregated estimates for one unit or a group of units.
+ */
+struct EnergySummary {
+    qint64 samples = 0;          ///< Number of samples aggregated.
+    double energyKWh = 0.0;      ///< Estimated energy consumed.
+    double onHours = 0.0;        ///< Time in BlockStatus::BLOCK_ON.
+    double errorHours = 0.0;     ///< Time in BlockStatus::BLOCK_ERROR.
+    double offHours = 0.0;       ///< Time in BlockStatus::BLOCK_OFF.
+    double comfortHours = 0.0;   ///< Running time within EnergyModel::comfortBandC of the setpoint.
+    double absErrorDegHours = 0.0; ///< Integral of |setpoint - actual| over running time.
+    double peakPowerW = 0.0;     ///< Highest estimated draw of a single unit.
+
+    /**
+     * @brief Returns the mean draw over the whole period, in Watts.
+     */
+    double averagePowerW() const;
+
+    /**
+     * @brief Returns the mean difference from the setpoint while running, in degrees Celsius.
+     */
+    double meanAbsErrorC() const;
+
+    /**
+     * @brief Returns comfortable running hours per kWh, the efficiency figure shown to users.
+     */
+    double comfortHoursPerKWh() const;
+
+    /**
+     * @brief Adds the totals of another summary; the peak becomes the larger one.
+     * @param other Summary to add.
+     */
+    void merge(const EnergySummary &other);
+};
+
+/**
+ * @brief Aggregates the history of one unit.
+ * @param history Unit history.
+ * @param model Power draw coefficients.
+ */
+EnergySummary analyzeEnergy(const EnergyHistory &history, const EnergyModel &model = EnergyModel());
+
+/**
+ * @brief Aggregates the histories of many units.
+ * @param histories Unit histories.
+ * @param model Power draw coefficients.
+ * @param perUnit Receives one summary per history.
+ * @return Totals over all units.
+ */
+EnergySummary analyzeEnergy(const std::vector<EnergyHistory> &histories, const EnergyModel &model,
+                            std::vector<EnergySummary> &perUnit);
+
+#endif // ENERGYANALYTICS_H
@@ -0,0 +1,82 @@
+#include "energybenchmark.h"
+#include "energyanalytics.h"
+#include "mockcontroller.h"
+
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+const int poolSize = 64;
+const int samplesPerDay = 24 * 60;
+const int historyDays = 30;
+const int errorPercent = 10;
+
+/**
+ * @brief Simulates a month of per-minute history of one unit.
+ *
+ * The unit is off at night, in error for about errorPercent of the day, and
+ * changes its setpoint and airflow direction a few times a day.
+ */
+EnergyHistory simulateHistory() {
+    EnergyHistory history;
+    history.reserve(static_cast<qint64>(samplesPerDay) * historyDays);
+
+    double setpoint = 22.0;
+    AirFlowDirection direction = AirFlowDirection::AUTO;
+    for (int day = 0; day < historyDays; ++day) {
+        for (int minute = 0; minute < samplesPerDay; ++minute) {
+            if (minute % 240 == 0) {
+                setpoint = 18 + std::rand() % 9;
+                direction = static_cast<AirFlowDirection>(std::rand() % 4);
+            }
+
+            const bool night = minute < 7 * 60 || minute >= 23 * 60;
+            BlockStatus status = BlockStatus::BLOCK_ON;
+            if (night)
+                status = BlockStatus::BLOCK_OFF;
+            else if (std::rand() % 100 < errorPercent)
+                status = BlockStatus::BLOCK_ERROR;
+
+            history.append(static_cast<float>(setpoint), static_cast<float>(MockController::sampleTemperature(setpoint)),
+                           static_cast<float>(MockController::sampleHumidity()), direction, status);
+        }
+    }
+    return history;
+}
+
+}
+
+int runEnergyBenchmark(int units) {
+    units = std::max(1, units);
+
+    std::vector<EnergyHistory> pool;
+    pool.reserve(poolSize);
+    for (int i = 0; i < poolSize; ++i)
+        pool.push_back(simulateHistory());
+
+    const EnergyModel model;
+    EnergySummary total;
+    qint64 samples = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int unit = 0; unit < units; ++unit) {
+        const EnergySummary summary = analyzeEnergy(pool[unit % poolSize], model);
+        samples += summary.samples;
+        total.merge(summary);
+    }
+    const qint64 elapsedNs = std::max<qint64>(1, timer.nsecsElapsed());
+
+    qInfo().noquote() << QString("energy: %1 units, %2 samples in %3 ms, %4 M samples/s, "
+                                 "%5 kWh, %6 comfortable hours per kWh, peak %7 W")
+                             .arg(units).arg(samples).arg(elapsedNs / 1e6, 0, 'f', 1)
+                             .arg(samples * 1e3 / elapsedNs, 0, 'f', 1)
+                             .arg(total.energyKWh, 0, 'f', 0)
+                             .arg(total.comfortHoursPerKWh(), 0, 'f', 3)
+                             .arg(total.peakPowerW, 0, 'f', 0);
+    return 0;
+}
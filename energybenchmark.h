@@ -0,0 +1,21 @@
+#ifndef ENERGYBENCHMARK_H
+#define ENERGYBENCHMARK_H
+
+/**
+ * @file energybenchmark.h
+ * @brief Measures the throughput of the energy analytics kernels.
+ */
+
+/**
+ * @brief Aggregates a month of per-minute history for many units and prints the throughput.
+ *
+ * Histories are simulated from MockController readings for a pool of units
+ * that is reused round-robin, so memory use does not grow with the number
+ * of units while the kernels still read from beyond the caches.
+ *
+ * @param units Number of units to aggregate.
+ * @return Process exit code.
+ */
+int runEnergyBenchmark(int units);
+
+#endif // ENERGYBENCHMARK_H
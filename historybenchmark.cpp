@@ -0,0 +1,143 @@
+#include "historybenchmark.h"
+#include "mockcontroller.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <QDateTime>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+void report(const QString &name, const HistoryBenchmarkResult &result) {
+    if (result.samples == 0) {
+        qInfo().noquote() << name << ": round trip FAILED";
+        return;
+    }
+
+    qInfo().noquote() << QString("%1: %2 samples, %3 -> %4 bytes, ratio %5x (%6 bits/sample), "
+                                 "encode %7 M samples/s, decode %8 M samples/s")
+                             .arg(name).arg(result.samples).arg(result.rawBytes).arg(result.compressedBytes)
+                             .arg(static_cast<double>(result.rawBytes) / result.compressedBytes, 0, 'f', 2)
+                             .arg(result.compressedBytes * 8.0 / result.samples, 0, 'f', 2)
+                             .arg(result.encodeSamplesPerSec / 1e6, 0, 'f', 1)
+                             .arg(result.decodeSamplesPerSec / 1e6, 0, 'f', 1);
+}
+
+bool benchmarkSet(const QString &source, const std::vector<HistorySample> &temperature,
+                  const std::vector<HistorySample> &humidity, const std::vector<HistorySample> &pressure) {
+    bool ok = true;
+    const std::pair<QString, const std::vector<HistorySample> *> series[] = {
+        {"temperature", &temperature}, {"humidity", &humidity}, {"pressure", &pressure}
+    };
+    for (const auto &entry : series) {
+        if (entry.second->empty())
+            continue;
+        HistoryBenchmarkResult result = benchmarkHistory(*entry.second);
+        report(source + " " + entry.first, result);
+        ok = ok && result.samples > 0;
+    }
+    return ok;
+}
+
+}
+
+HistoryBenchmarkResult benchmarkHistory(const std::vector<HistorySample> &samples) {
+    HistoryBenchmarkResult result;
+    if (samples.empty())
+        return result;
+
+    HistorySeries series;
+    QElapsedTimer timer;
+
+    timer.start();
+    for (const HistorySample &sample : samples)
+        series.append(sample.timestampMs, sample.value);
+    const qint64 encodeNs = std::max<qint64>(1, timer.nsecsElapsed());
+
+    size_t index = 0;
+    bool matches = true;
+    timer.restart();
+    for (const HistoryChunk &chunk : series.chunkList()) {
+        HistoryChunk::Reader reader = chunk.reader();
+        HistorySample sample;
+        while (reader.next(sample)) {
+            matches = matches && index < samples.size()
+                      && sample.timestampMs == samples[index].timestampMs
+                      && std::memcmp(&sample.value, &samples[index].value, sizeof(double)) == 0;
+            ++index;
+        }
+    }
+    const qint64 decodeNs = std::max<qint64>(1, timer.nsecsElapsed());
+
+    if (!matches || index != samples.size())
+        return result;
+
+    result.samples = static_cast<qint64>(samples.size());
+    result.rawBytes = result.samples * static_cast<qint64>(sizeof(qint64) + sizeof(double));
+    result.compressedBytes = series.byteSize();
+    result.encodeSamplesPerSec = result.samples * 1e9 / encodeNs;
+    result.decodeSamplesPerSec = result.samples * 1e9 / decodeNs;
+    return result;
+}
+
+int runHistoryBenchmark(const QString &tracePath) {
+    const qint64 intervalMs = 2000;
+    const qint64 sampleCount = 30LL * 24 * 3600 * 1000 / intervalMs;
+
+    std::vector<HistorySample> temperature, humidity, pressure;
+    temperature.reserve(sampleCount);
+    humidity.reserve(sampleCount);
+    pressure.reserve(sampleCount);
+
+    qint64 timestamp = QDateTime::currentMSecsSinceEpoch();
+    for (qint64 i = 0; i < sampleCount; ++i) {
+        timestamp += intervalMs + (std::rand() % 5 - 2);
+        temperature.push_back({timestamp, MockController::sampleTemperature(22.0)});
+        humidity.push_back({timestamp, MockController::sampleHumidity()});
+        pressure.push_back({timestamp, MockController::samplePressure()});
+    }
+
+    bool ok = benchmarkSet("mock", temperature, humidity, pressure);
+
+    if (tracePath.isEmpty())
+        return ok ? 0 : 1;
+
+    QFile file(tracePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning().noquote() << "Cannot open trace" << tracePath;
+        return 1;
+    }
+
+    temperature.clear();
+    humidity.clear();
+    pressure.clear();
+
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QStringList fields = in.readLine().split(',');
+        if (fields.size() < 4)
+            continue;
+
+        bool valid = false;
+        const qint64 ts = fields[0].trimmed().toLongLong(&valid);
+        if (!valid)
+            continue;
+
+        temperature.push_back({ts, fields[1].toDouble()});
+        humidity.push_back({ts, fields[2].toDouble()});
+        pressure.push_back({ts, fields[3].toDouble()});
+    }
+
+    const auto byTimestamp = [](const HistorySample &a, const HistorySample &b) {
+        return a.timestampMs < b.timestampMs;
+    };
+    std::stable_sort(temperature.begin(), temperature.end(), byTimestamp);
+    std::stable_sort(humidity.begin(), humidity.end(), byTimestamp);
+    std::stable_sort(pressure.begin(), pressure.end(), byTimestamp);
+
+    ok = benchmarkSet("trace", temperature, humidity, pressure) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+#ifndef HISTORYBENCHMARK_H
+#define HISTORYBENCHMARK_H
+
+/**
+ * @file historybenchmark.h
+ * @brief Measures compression ratio and throughput of the sensor history format.
+ */
+
+#include <QString>
+#include "sensorhistory.h"
+
+/**
+ * @struct HistoryBenchmarkResult
+ * @brief Results of compressing one series.
+ */
+struct HistoryBenchmarkResult {
+    qint64 samples = 0;              ///< Number of samples.
+    qint64 rawBytes = 0;             ///< Size as raw timestamp/double pairs.
+    qint64 compressedBytes = 0;      ///< Encoded size.
+    double encodeSamplesPerSec = 0;  ///< Append throughput.
+    double decodeSamplesPerSec = 0;  ///< Full decode throughput.
+};
+
+/**
+ * @brief Compresses a series and decodes it back, checking the round trip.
+ * @param samples Samples in timestamp order.
+ * @return Measured results; samples is 0 if decoding did not reproduce the input.
+ */
+HistoryBenchmarkResult benchmarkHistory(const std::vector<HistorySample> &samples);
+
+/**
+ * @brief Runs the benchmark on simulated data and optionally on a recorded trace, printing a report.
+ *
+ * Simulated data covers 30 days of MockController readings at its 2 s interval.
+ * A trace is a CSV file with lines "timestamp_ms,temperature,humidity,pressure".
+ *
+ * @param tracePath Path of a trace to replay, or an empty string.
+ * @return Process exit code.
+ */
+int runHistoryBenchmark(const QString &tracePath);
+
+#endif // HISTORYBENCHMARK_H
@@ -1,13 +1,99 @@
 #include "controllerwidget.h"
+#include "telemetrystressharness.h"
+#include "metricsserver.h"
+#include "historybenchmark.h"
+#include "themebenchmark.h"
+#include "commandbenchmark.h"
+#include "energybenchmark.h"
+#include "sharedstatetable.h"
 
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QStyleFactory>
+#include <QStyle>
+#include <QDebug>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    // ThemeEngine palettes are designed for Fusion, which draws every control from the palette.
+    if (QStyle *fusion = QStyleFactory::create("Fusion"))
+        QApplication::setStyle(fusion);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption stressOption("stress", "Run a telemetry stress test: constant, burst or ramp.", "pattern");
+    QCommandLineOption stressTargetOption("stress-target", "Where stress samples enter: slots or backend.", "target", "backend");
+    QCommandLineOption stressPolicyOption("stress-policy", "Load shedding policy: passthrough, latest or aggregate.", "policy", "latest");
+    QCommandLineOption stressRateOption("stress-rate", "Samples per second.", "rate", "100000");
+    QCommandLineOption stressBurstOption("stress-burst", "Samples per burst.", "size", "5000");
+    QCommandLineOption stressDurationOption("stress-duration", "Duration in milliseconds.", "ms", "10000");
+    QCommandLineOption metricsPortOption("metrics-port", "Serve Prometheus metrics on this port; disabled by default.", "port", "0");
+    QCommandLineOption metricsAddressOption("metrics-address", "Address the metrics endpoint listens on.", "address", "127.0.0.1");
+    QCommandLineOption benchmarkOption("benchmark", "Run a benchmark and exit: history, theme, commands or energy.", "name");
+    QCommandLineOption traceOption("trace", "CSV trace replayed by the history benchmark.", "file");
+    QCommandLineOption unitsOption("units", "Number of units used by benchmarks and simulated by a shared feed writer.", "count", "10000");
+    QCommandLineOption feedOption("feed", "Shared state feed: local, writer or reader.", "mode", "local");
+    parser.addOptions({stressOption, stressTargetOption, stressPolicyOption, stressRateOption, stressBurstOption, stressDurationOption,
+                       metricsPortOption, metricsAddressOption, benchmarkOption, traceOption, unitsOption, feedOption});
+    parser.process(a);
+
+    if (parser.isSet(benchmarkOption)) {
+        const QString benchmark = parser.value(benchmarkOption);
+        if (benchmark == "history")
+            return runHistoryBenchmark(parser.value(traceOption));
+        if (benchmark == "theme")
+            return runThemeBenchmark(parser.value(unitsOption).toInt());
+        if (benchmark == "commands")
+            return runCommandBenchmark(parser.value(unitsOption).toInt());
+        if (benchmark == "energy")
+            return runEnergyBenchmark(parser.value(unitsOption).toInt());
+        qWarning().noquote() << "Unknown benchmark" << benchmark;
+        return 1;
+    }
+
+    const quint16 metricsPort = parser.value(metricsPortOption).toUShort();
+    if (metricsPort != 0) {
+        const QHostAddress metricsAddress(parser.value(metricsAddressOption));
+        if (metricsAddress.isNull())
+            qWarning().noquote() << "Invalid metrics address" << parser.value(metricsAddressOption);
+        else
+            new MetricsServer(metricsPort, metricsAddress, &a);
+    }
+
     ControllerWidget widget;
     widget.show();
 
+    const QString feed = parser.value(feedOption);
+    if (feed == "writer")
+        widget.setSharedFeed(SharedFeedMode::WRITER, parser.value(unitsOption).toInt());
+    else if (feed == "reader")
+        widget.setSharedFeed(SharedFeedMode::READER, 0);
+
+    if (parser.isSet(stressOption)) {
+        StressConfig config;
+        const QString pattern = parser.value(stressOption);
+        config.pattern = pattern == "constant" ? StressPattern::CONSTANT
+                       : pattern == "ramp" ? StressPattern::RAMP
+                                           : StressPattern::BURST;
+        config.target = parser.value(stressTargetOption) == "slots" ? StressTarget::WIDGET_SLOTS
+                                                                     : StressTarget::BACKEND_BOUNDARY;
+        const QString policy = parser.value(stressPolicyOption);
+        config.policy = policy == "passthrough" ? SheddingPolicy::PASSTHROUGH
+                      : policy == "aggregate" ? SheddingPolicy::AGGREGATE
+                                              : SheddingPolicy::KEEP_LATEST;
+        config.ratePerSecond = parser.value(stressRateOption).toInt();
+        config.burstSize = parser.value(stressBurstOption).toInt();
+        config.durationMs = parser.value(stressDurationOption).toInt();
+
+        TelemetryStressHarness *harness = new TelemetryStressHarness(&widget, &widget);
+        QObject::connect(harness, &TelemetryStressHarness::finished, &a, [](const QString &report) {
+            qInfo().noquote() << report;
+            QApplication::quit();
+        });
+        harness->start(config);
+    }
+
     return a.exec();
 }
@@ -0,0 +1,187 @@
+#include "metrics.h"
+
+#include <QFile>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char *slotNames[] = {
+    "updateTemperature", "updateHumidity", "updatePressure", "updateAirflowDirection",
+    "setBlock1Status", "setBlock2Status", "setBlock3Status"
+};
+
+const char *statusNames[] = {"off", "error", "on"};
+
+const char *outcomeNames[] = {"acknowledged", "failed", "timed_out", "no_controller"};
+
+void updateMax(std::atomic<qint64> &max, qint64 value) {
+    qint64 current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+qint64 residentMemoryBytes() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return static_cast<qint64>(counters.WorkingSetSize);
+    return -1;
+#elif defined(Q_OS_LINUX)
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly))
+        return -1;
+    const QList<QByteArray> fields = statm.readAll().split(' ');
+    if (fields.size() < 2)
+        return -1;
+    return fields[1].toLongLong() * sysconf(_SC_PAGESIZE);
+#else
+    return -1;
+#endif
+}
+
+}
+
+MetricsRegistry &MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+void MetricsRegistry::countSlotUpdate(MetricsSlot slot) {
+    slotUpdates[static_cast<int>(slot)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::observeDisplayDuration(qint64 ns) {
+    size_t bucket = 0;
+    while (bucket < displayBucketsNs.size() && ns > displayBucketsNs[bucket])
+        ++bucket;
+
+    displayBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    displaySumNs.fetch_add(static_cast<quint64>(ns), std::memory_order_relaxed);
+    displayCount.fetch_add(1, std::memory_order_relaxed);
+    updateMax(displayMaxNs, ns);
+}
+
+void MetricsRegistry::recordBlockStatus(int block, BlockStatus status) {
+    if (block < 0 || block >= ControllerWidget::BLOCK_COUNT)
+        return;
+
+    const int value = static_cast<int>(status);
+    if (blockStatuses[block].exchange(value, std::memory_order_relaxed) != value)
+        blockTransitions[block][value].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::observeSimulationTick(qint64 lagNs) {
+    tickLagNs.store(lagNs, std::memory_order_relaxed);
+    updateMax(tickLagMaxNs, lagNs);
+    ticks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MetricsRegistry::observeCommand(CommandOutcome outcome, qint64 latencyNs) {
+    commandOutcomes[static_cast<int>(outcome)].fetch_add(1, std::memory_order_relaxed);
+    if (outcome == CommandOutcome::TIMED_OUT || outcome == CommandOutcome::NO_CONTROLLER)
+        return;
+
+    size_t bucket = 0;
+    while (bucket < commandBucketsNs.size() && latencyNs > commandBucketsNs[bucket])
+        ++bucket;
+
+    commandBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    commandSumNs.fetch_add(static_cast<quint64>(latencyNs), std::memory_order_relaxed);
+    updateMax(commandMaxNs, latencyNs);
+}
+
+QByteArray MetricsRegistry::renderPrometheus() const {
+    QByteArray out;
+    out.reserve(4096);
+
+    out += "# HELP ac_slot_updates_total Calls of ControllerWidget update slots.\n"
+           "# TYPE ac_slot_updates_total counter\n";
+    for (int i = 0; i < static_cast<int>(MetricsSlot::SLOT_COUNT); ++i)
+        out += "ac_slot_updates_total{slot=\"" + QByteArray(slotNames[i]) + "\"} "
+               + QByteArray::number(slotUpdates[i].load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP ac_update_display_seconds Duration of ControllerWidget::updateDisplay().\n"
+           "# TYPE ac_update_display_seconds histogram\n";
+    quint64 cumulative = 0;
+    for (size_t i = 0; i < displayBucketsNs.size(); ++i) {
+        cumulative += displayBuckets[i].load(std::memory_order_relaxed);
+        out += "ac_update_display_seconds_bucket{le=\"" + QByteArray::number(displayBucketsNs[i] / 1e9, 'g', 6) + "\"} "
+               + QByteArray::number(cumulative) + "\n";
+    }
+    cumulative += displayBuckets.back().load(std::memory_order_relaxed);
+    out += "ac_update_display_seconds_bucket{le=\"+Inf\"} " + QByteArray::number(cumulative) + "\n";
+    out += "ac_update_display_seconds_sum " + QByteArray::number(displaySumNs.load(std::memory_order_relaxed) / 1e9, 'g', 9) + "\n";
+    out += "ac_update_display_seconds_count " + QByteArray::number(displayCount.load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP ac_update_display_max_seconds Longest updateDisplay() call since start.\n"
+           "# TYPE ac_update_display_max_seconds gauge\n"
+           "ac_update_display_max_seconds " + QByteArray::number(displayMaxNs.load(std::memory_order_relaxed) / 1e9, 'g', 9) + "\n";
+
+    out += "# HELP ac_block_status_transitions_total Block status changes by target status.\n"
+           "# TYPE ac_block_status_transitions_total counter\n";
+    for (int block = 0; block < ControllerWidget::BLOCK_COUNT; ++block)
+        for (int status = 0; status < 3; ++status)
+            out += "ac_block_status_transitions_total{block=\"" + QByteArray::number(block + 1) + "\",to=\""
+                   + statusNames[status] + "\"} "
+                   + QByteArray::number(blockTransitions[block][status].load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP ac_block_errors_total Times a block entered the error state.\n"
+           "# TYPE ac_block_errors_total counter\n";
+    for (int block = 0; block < ControllerWidget::BLOCK_COUNT; ++block)
+        out += "ac_block_errors_total{block=\"" + QByteArray::number(block + 1) + "\"} "
+               + QByteArray::number(blockTransitions[block][static_cast<int>(BlockStatus::BLOCK_ERROR)].load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP ac_block_status Current block status (0 = off, 1 = error, 2 = on).\n"
+           "# TYPE ac_block_status gauge\n";
+    for (int block = 0; block < ControllerWidget::BLOCK_COUNT; ++block)
+        out += "ac_block_status{block=\"" + QByteArray::number(block + 1) + "\"} "
+               + QByteArray::number(blockStatuses[block].load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP ac_simulation_tick_lag_seconds Delay of the last simulation tick past its schedule.\n"
+           "# TYPE ac_simulation_tick_lag_seconds gauge\n"
+           "ac_simulation_tick_lag_seconds " + QByteArray::number(tickLagNs.load(std::memory_order_relaxed) / 1e9, 'g', 9) + "\n"
+           "# HELP ac_simulation_tick_lag_max_seconds Largest simulation tick delay since start.\n"
+           "# TYPE ac_simulation_tick_lag_max_seconds gauge\n"
+           "ac_simulation_tick_lag_max_seconds " + QByteArray::number(tickLagMaxNs.load(std::memory_order_relaxed) / 1e9, 'g', 9) + "\n"
+           "# HELP ac_simulation_ticks_total Simulation ticks performed.\n"
+           "# TYPE ac_simulation_ticks_total counter\n"
+           "ac_simulation_ticks_total " + QByteArray::number(ticks.load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP ac_commands_total Controller commands by outcome.\n"
+           "# TYPE ac_commands_total counter\n";
+    for (int i = 0; i < static_cast<int>(commandOutcomes.size()); ++i)
+        out += "ac_commands_total{outcome=\"" + QByteArray(outcomeNames[i]) + "\"} "
+               + QByteArray::number(commandOutcomes[i].load(std::memory_order_relaxed)) + "\n";
+
+    out += "# HELP ac_command_round_trip_seconds Time from sending a command to its acknowledgement or failure.\n"
+           "# TYPE ac_command_round_trip_seconds histogram\n";
+    cumulative = 0;
+    for (size_t i = 0; i < commandBucketsNs.size(); ++i) {
+        cumulative += commandBuckets[i].load(std::memory_order_relaxed);
+        out += "ac_command_round_trip_seconds_bucket{le=\"" + QByteArray::number(commandBucketsNs[i] / 1e9, 'g', 6) + "\"} "
+               + QByteArray::number(cumulative) + "\n";
+    }
+    cumulative += commandBuckets.back().load(std::memory_order_relaxed);
+    out += "ac_command_round_trip_seconds_bucket{le=\"+Inf\"} " + QByteArray::number(cumulative) + "\n";
+    out += "ac_command_round_trip_seconds_sum " + QByteArray::number(commandSumNs.load(std::memory_order_relaxed) / 1e9, 'g', 9) + "\n";
+    out += "ac_command_round_trip_seconds_count " + QByteArray::number(cumulative) + "\n";
+
+    out += "# HELP ac_command_round_trip_max_seconds Longest command round trip since start.\n"
+           "# TYPE ac_command_round_trip_max_seconds gauge\n"
+           "ac_command_round_trip_max_seconds " + QByteArray::number(commandMaxNs.load(std::memory_order_relaxed) / 1e9, 'g', 9) + "\n";
+
+    const qint64 memory = residentMemoryBytes();
+    if (memory >= 0) {
+        out += "# HELP ac_process_resident_memory_bytes Resident memory of the process.\n"
+               "# TYPE ac_process_resident_memory_bytes gauge\n"
+               "ac_process_resident_memory_bytes " + QByteArray::number(memory) + "\n";
+    }
+
+    return out;
+}
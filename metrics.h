@@ -0,0 +1,118 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/**
+ * @file metrics.h
+ * @brief Defines the process-wide registry of health counters exported in Prometheus format.
+ */
+
+#include <QByteArray>
+#include <atomic>
+#include <array>
+#include "controllerwidget.h"
+#include "commandchannel.h"
+
+/**
+ * @enum MetricsSlot
+ * @brief ControllerWidget slots whose call rate is counted.
+ */
+enum class MetricsSlot {
+    UPDATE_TEMPERATURE,  ///< updateTemperature()
+    UPDATE_HUMIDITY,     ///< updateHumidity()
+    UPDATE_PRESSURE,     ///< updatePressure()
+    UPDATE_AIRFLOW,      ///< updateAirflowDirection()
+    SET_BLOCK1_STATUS,   ///< setBlock1Status()
+    SET_BLOCK2_STATUS,   ///< setBlock2Status()
+    SET_BLOCK3_STATUS,   ///< setBlock3Status()
+    SLOT_COUNT           ///< Number of counted slots
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Lock-free counters shared between the GUI thread and the metrics endpoint.
+ *
+ * Recording only touches relaxed atomics, so it is cheap enough to call on
+ * every update, and rendering can run on any thread without blocking writers.
+ */
+class MetricsRegistry {
+public:
+    /**
+     * @brief Returns the process-wide registry.
+     */
+    static MetricsRegistry &instance();
+
+    /**
+     * @brief Counts a call of a ControllerWidget slot.
+     * @param slot The slot that was called.
+     */
+    void countSlotUpdate(MetricsSlot slot);
+
+    /**
+     * @brief Records the duration of one updateDisplay() call.
+     * @param ns Duration in nanoseconds.
+     */
+    void observeDisplayDuration(qint64 ns);
+
+    /**
+     * @brief Records a block status, counting a transition if it changed.
+     * @param block Block index starting at 0.
+     * @param status The new status.
+     */
+    void recordBlockStatus(int block, BlockStatus status);
+
+    /**
+     * @brief Records how late a simulation tick fired.
+     * @param lagNs Delay past the scheduled time in nanoseconds.
+     */
+    void observeSimulationTick(qint64 lagNs);
+
+    /**
+     * @brief Records the outcome and round-trip time of a controller command.
+     * @param outcome How the command ended.
+     * @param latencyNs Time from sending to the outcome in nanoseconds.
+     */
+    void observeCommand(CommandOutcome outcome, qint64 latencyNs);
+
+    /**
+     * @brief Renders all metrics in the Prometheus text exposition format.
+     */
+    QByteArray renderPrometheus() const;
+
+private:
+    MetricsRegistry() = default;
+
+    /**
+     * @brief Upper bounds of the updateDisplay() duration histogram in nanoseconds.
+     */
+    static constexpr std::array<qint64, 10> displayBucketsNs = {
+        100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000, 25000000, 50000000, 100000000
+    };
+
+    /**
+     * @brief Upper bounds of the command round-trip histogram in nanoseconds.
+     */
+    static constexpr std::array<qint64, 10> commandBucketsNs = {
+        1000000, 5000000, 10000000, 25000000, 50000000, 100000000, 250000000, 500000000, 1000000000, 2500000000
+    };
+
+    std::array<std::atomic<quint64>, static_cast<int>(MetricsSlot::SLOT_COUNT)> slotUpdates{}; ///< Calls per slot.
+
+    std::array<std::atomic<quint64>, displayBucketsNs.size() + 1> displayBuckets{}; ///< Non-cumulative histogram buckets, the last one is +Inf.
+    std::atomic<quint64> displaySumNs{0};  ///< Total updateDisplay() time.
+    std::atomic<quint64> displayCount{0};  ///< Number of updateDisplay() calls.
+    std::atomic<qint64> displayMaxNs{0};   ///< Longest updateDisplay() call.
+
+    std::array<std::atomic<int>, ControllerWidget::BLOCK_COUNT> blockStatuses{}; ///< Last status of each block.
+    std::array<std::array<std::atomic<quint64>, 3>, ControllerWidget::BLOCK_COUNT> blockTransitions{}; ///< Transitions per block and target status.
+
+    std::atomic<qint64> tickLagNs{0};      ///< Delay of the last simulation tick.
+    std::atomic<qint64> tickLagMaxNs{0};   ///< Largest simulation tick delay.
+    std::atomic<quint64> ticks{0};         ///< Number of simulation ticks.
+
+    std::array<std::atomic<quint64>, 4> commandOutcomes{}; ///< Commands per CommandOutcome.
+    std::array<std::atomic<quint64>, commandBucketsNs.size() + 1> commandBuckets{}; ///< Non-cumulative round-trip buckets of answered commands, the last one is +Inf.
+    std::atomic<quint64> commandSumNs{0};  ///< Total round-trip time of answered commands.
+    std::atomic<qint64> commandMaxNs{0};   ///< Longest round trip of an answered command.
+};
+
+#endif // METRICS_H
@@ -0,0 +1,74 @@
+#include "metricsserver.h"
+#include "metrics.h"
+
+#include <QHostAddress>
+#include <QDebug>
+
+class MetricsServer::Worker : public QObject {
+public:
+    Worker(quint16 port, const QHostAddress &address) : port(port), address(address) {}
+
+    void start() {
+        server = new QTcpServer(this);
+        connect(server, &QTcpServer::newConnection, this, [this] { acceptConnections(); });
+        if (!server->listen(address, port))
+            qWarning() << "Metrics endpoint could not listen on" << address.toString() << "port" << port << ":" << server->errorString();
+    }
+
+private:
+    void acceptConnections() {
+        while (QTcpSocket *socket = server->nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, socket, [socket] { respond(socket); });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
+
+    static void respond(QTcpSocket *socket) {
+        if (!socket->canReadLine() || socket->property("answered").toBool())
+            return;
+        socket->setProperty("answered", true);
+
+        const QList<QByteArray> request = socket->readLine().trimmed().split(' ');
+        const bool isMetrics = request.size() >= 2 && request[0] == "GET"
+                               && (request[1] == "/metrics" || request[1].startsWith("/metrics?"));
+
+        QByteArray body;
+        QByteArray status;
+        QByteArray type;
+        if (isMetrics) {
+            body = MetricsRegistry::instance().renderPrometheus();
+            status = "200 OK";
+            type = "text/plain; version=0.0.4; charset=utf-8";
+        }
+        else {
+            body = "Not Found\n";
+            status = "404 Not Found";
+            type = "text/plain; charset=utf-8";
+        }
+
+        socket->write("HTTP/1.1 " + status + "\r\n"
+                      "Content-Type: " + type + "\r\n"
+                      "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                      "Connection: close\r\n\r\n");
+        socket->write(body);
+        socket->disconnectFromHost();
+    }
+
+    quint16 port;                 ///< Port to listen on.
+    QHostAddress address;         ///< Address to listen on.
+    QTcpServer *server = nullptr; ///< Listening socket.
+};
+
+MetricsServer::MetricsServer(quint16 port, const QHostAddress &address, QObject *parent) : QObject(parent) {
+    worker = new Worker(port, address);
+    worker->moveToThread(&thread);
+    connect(&thread, &QThread::finished, worker, &QObject::deleteLater);
+    thread.setObjectName("MetricsServer");
+    thread.start(QThread::LowPriority);
+    QMetaObject::invokeMethod(worker, [this] { worker->start(); }, Qt::QueuedConnection);
+}
+
+MetricsServer::~MetricsServer() {
+    thread.quit();
+    thread.wait();
+}
@@ -0,0 +1,51 @@
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+/**
+ * @file metricsserver.h
+ * @brief Serves MetricsRegistry over a local HTTP endpoint.
+ */
+
+#include <QObject>
+#include <QThread>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHostAddress>
+
+/**
+ * @class MetricsServer
+ * @brief Answers GET /metrics with the Prometheus text format, on the loopback interface unless told otherwise.
+ *
+ * The server lives on its own thread, so scrapes never wait for the GUI
+ * event loop and a slow scraper cannot stall the interface.
+ */
+class MetricsServer : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor. Starts the worker thread and listens on the given port.
+     * @param port TCP port.
+     * @param address Address to listen on.
+     * @param parent Optional parent.
+     */
+    explicit MetricsServer(quint16 port, const QHostAddress &address = QHostAddress(QHostAddress::LocalHost),
+                           QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor. Stops the worker thread.
+     */
+    ~MetricsServer();
+
+private:
+    /**
+     * @class Worker
+     * @brief Owns the listening socket on the worker thread.
+     */
+    class Worker;
+
+    QThread thread;           ///< Thread handling scrapes.
+    Worker *worker = nullptr; ///< Object living on the worker thread.
+};
+
+#endif // METRICSSERVER_H
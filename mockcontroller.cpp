@@ -1,4 +1,20 @@
 #include "mockcontroller.h"
+#include "unittablemodel.h"
+#include "telemetrythrottle.h"
+#include "metrics.h"
+
+#include <algorithm>
+
+namespace {
+
+const int rejectPercent = 2;
+const int lostPercent = 1;
+
+double statusValue(BlockStatus status) {
+    return static_cast<int>(status);
+}
+
+}
 
 
 MockController::MockController(ControllerWidget* widget, QObject* parent)
@@ -6,31 +22,68 @@ MockController::MockController(ControllerWidget* widget, QObject* parent)
 {
     std::srand(std::time(nullptr));
 
-    connect(widget, &ControllerWidget::turnOnRequest, this, &MockController::onTurnOn);
-    connect(widget, &ControllerWidget::turnOffRequest, this, &MockController::onTurnOff);
-    connect(widget, &ControllerWidget::desiredTemperatureChanged, this, &MockController::onTemperatureChanged);
-    connect(widget, &ControllerWidget::desiredAirFlowChanged, this, &MockController::onAirFlowChanged);
+    connect(widget->commandChannel(), &CommandChannel::commandIssued, this, &MockController::onCommand);
 
     connect(&simulationTimer, &QTimer::timeout, this, &MockController::simulateStep);
     simulationTimer.setInterval(2000);
+
+    connect(&fleetTimer, &QTimer::timeout, this, &MockController::simulateFleetStep);
+    fleetTimer.setInterval(1000);
+}
+
+double MockController::sampleTemperature(double target) {
+    return target + ((std::rand() % 5 - 2) * 0.5);
+}
+
+double MockController::sampleHumidity() {
+    return 40.0 + (std::rand() % 20);
+}
+
+double MockController::samplePressure() {
+    return 100000 + (std::rand() % 5000);
 }
 
 void MockController::onTurnOn() {
     running = true;
     simulationTimer.start();
+    tickClock.start();
+    if (fleetSize > 0)
+        fleetTimer.start();
 
-    widget->setBlock1Status(BlockStatus::BLOCK_ON);
-    widget->setBlock2Status(BlockStatus::BLOCK_ON);
-    widget->setBlock3Status(BlockStatus::BLOCK_ON);
+    TelemetryThrottle *telemetry = widget->telemetryInput();
+    telemetry->submit(TelemetryChannel::BLOCK1_STATUS, statusValue(BlockStatus::BLOCK_ON));
+    telemetry->submit(TelemetryChannel::BLOCK2_STATUS, statusValue(BlockStatus::BLOCK_ON));
+    telemetry->submit(TelemetryChannel::BLOCK3_STATUS, statusValue(BlockStatus::BLOCK_ON));
 }
 
 void MockController::onTurnOff() {
     running = false;
     simulationTimer.stop();
+    fleetTimer.stop();
+
+    TelemetryThrottle *telemetry = widget->telemetryInput();
+    telemetry->submit(TelemetryChannel::BLOCK1_STATUS, statusValue(BlockStatus::BLOCK_OFF));
+    telemetry->submit(TelemetryChannel::BLOCK2_STATUS, statusValue(BlockStatus::BLOCK_OFF));
+    telemetry->submit(TelemetryChannel::BLOCK3_STATUS, statusValue(BlockStatus::BLOCK_OFF));
+
+    UnitTableModel *model = widget->unitModel();
+    for (int row = ControllerWidget::BLOCK_COUNT; row < model->unitCount(); ++row) {
+        UnitState state = model->unit(row);
+        state.status = BlockStatus::BLOCK_OFF;
+        model->setUnit(row, state);
+    }
+}
+
+void MockController::setFleetSize(int count) {
+    fleetSize = count;
+    fleetTargets.resize(count, currentTemperature);
+    fleetPowered.resize(count, true);
+    widget->unitModel()->resize(ControllerWidget::BLOCK_COUNT + count);
 
-    widget->setBlock1Status(BlockStatus::BLOCK_OFF);
-    widget->setBlock2Status(BlockStatus::BLOCK_OFF);
-    widget->setBlock3Status(BlockStatus::BLOCK_OFF);
+    if (running && fleetSize > 0)
+        fleetTimer.start();
+    else
+        fleetTimer.stop();
 }
 
 void MockController::onTemperatureChanged(int value) {
@@ -38,37 +91,129 @@ void MockController::onTemperatureChanged(int value) {
 }
 
 void MockController::onAirFlowChanged(AirFlowDirection dir) {
-    widget->updateAirflowDirection(dir);
+    widget->telemetryInput()->submit(TelemetryChannel::AIRFLOW, static_cast<int>(dir));
+}
+
+void MockController::onCommand(const ControllerCommand &command) {
+    const int latencyMs = MIN_ACK_LATENCY_MS + std::rand() % (MAX_ACK_LATENCY_MS - MIN_ACK_LATENCY_MS + 1);
+    QTimer::singleShot(latencyMs, this, [this, command]() { applyCommand(command); });
+}
+
+void MockController::applyCommand(const ControllerCommand &command) {
+    const int roll = std::rand() % 100;
+    if (roll < lostPercent)
+        return;
+    if (roll < lostPercent + rejectPercent) {
+        widget->commandChannel()->acknowledge(command.id, false);
+        return;
+    }
+
+    if (command.unit < ControllerWidget::BLOCK_COUNT) {
+        switch (command.action) {
+        case ScheduleAction::TURN_ON:
+            onTurnOn();
+            break;
+        case ScheduleAction::TURN_OFF:
+            onTurnOff();
+            break;
+        case ScheduleAction::SET_TEMPERATURE:
+            onTemperatureChanged(command.value);
+            break;
+        case ScheduleAction::SET_AIRFLOW:
+            onAirFlowChanged(static_cast<AirFlowDirection>(command.value));
+            break;
+        }
+    }
+    else if (!applyFleetCommand(command.unit, command.action, command.value)) {
+        // Not one of ours; another controller on the channel answers it.
+        return;
+    }
+
+    widget->commandChannel()->acknowledge(command.id, true);
+}
+
+bool MockController::applyFleetCommand(int unit, ScheduleAction action, int value) {
+    const int index = unit - ControllerWidget::BLOCK_COUNT;
+    if (index < 0 || index >= fleetSize)
+        return false;
+
+    UnitTableModel *model = widget->unitModel();
+    UnitState state = model->unit(unit);
+    switch (action) {
+    case ScheduleAction::TURN_ON:
+        fleetPowered[index] = true;
+        state.status = running ? BlockStatus::BLOCK_ON : BlockStatus::BLOCK_OFF;
+        break;
+    case ScheduleAction::TURN_OFF:
+        fleetPowered[index] = false;
+        state.status = BlockStatus::BLOCK_OFF;
+        break;
+    case ScheduleAction::SET_TEMPERATURE:
+        fleetTargets[index] = value;
+        state.setpointC = value;
+        break;
+    case ScheduleAction::SET_AIRFLOW:
+        state.airflow = static_cast<AirFlowDirection>(value);
+        break;
+    }
+    model->setUnit(unit, state);
+    return true;
 }
 
 void MockController::simulateStep() {
     if (!running) return;
 
-    double actualTemp = currentTemperature + ((std::rand() % 5 - 2) * 0.5);
-    double humidity = 40.0 + (std::rand() % 20);
-    double pressure = 100000 + (std::rand() % 5000);
+    const qint64 expectedNs = static_cast<qint64>(simulationTimer.interval()) * 1000000;
+    MetricsRegistry::instance().observeSimulationTick(std::max<qint64>(0, tickClock.nsecsElapsed() - expectedNs));
+    tickClock.restart();
 
-    widget->updateTemperature(actualTemp);
-    widget->updateHumidity(humidity);
-    widget->updatePressure(pressure);
+    double actualTemp = sampleTemperature(currentTemperature);
+    double humidity = sampleHumidity();
+    double pressure = samplePressure();
+
+    TelemetryThrottle *telemetry = widget->telemetryInput();
+    telemetry->submit(TelemetryChannel::TEMPERATURE, actualTemp);
+    telemetry->submit(TelemetryChannel::HUMIDITY, humidity);
+    telemetry->submit(TelemetryChannel::PRESSURE, pressure);
 
     int random1 = std::rand() % 10;
     int random2 = std::rand() % 10;
     int random3 = std::rand() % 10;
 
     if (random1 == 0) {
-        widget->setBlock1Status(BlockStatus::BLOCK_ERROR);
+        telemetry->submit(TelemetryChannel::BLOCK1_STATUS, statusValue(BlockStatus::BLOCK_ERROR));
     } else {
-        widget->setBlock1Status(BlockStatus::BLOCK_ON);
+        telemetry->submit(TelemetryChannel::BLOCK1_STATUS, statusValue(BlockStatus::BLOCK_ON));
     }
     if (random2 == 0) {
-        widget->setBlock2Status(BlockStatus::BLOCK_ERROR);
+        telemetry->submit(TelemetryChannel::BLOCK2_STATUS, statusValue(BlockStatus::BLOCK_ERROR));
     } else {
-        widget->setBlock2Status(BlockStatus::BLOCK_ON);
+        telemetry->submit(TelemetryChannel::BLOCK2_STATUS, statusValue(BlockStatus::BLOCK_ON));
     }
     if (random3 == 0) {
-        widget->setBlock3Status(BlockStatus::BLOCK_ERROR);
+        telemetry->submit(TelemetryChannel::BLOCK3_STATUS, statusValue(BlockStatus::BLOCK_ERROR));
     } else {
-        widget->setBlock3Status(BlockStatus::BLOCK_ON);
+        telemetry->submit(TelemetryChannel::BLOCK3_STATUS, statusValue(BlockStatus::BLOCK_ON));
+    }
+}
+
+void MockController::simulateFleetStep() {
+    if (!running) return;
+
+    UnitTableModel *model = widget->unitModel();
+    for (int index = 0; index < fleetSize; ++index) {
+        const int row = ControllerWidget::BLOCK_COUNT + index;
+        UnitState state = model->unit(row);
+        state.setpointC = fleetTargets[index];
+        state.humidity = sampleHumidity();
+        state.pressurePa = samplePressure();
+        if (fleetPowered[index]) {
+            state.temperatureC = sampleTemperature(fleetTargets[index]);
+            state.status = (std::rand() % 10 == 0) ? BlockStatus::BLOCK_ERROR : BlockStatus::BLOCK_ON;
+        }
+        else {
+            state.status = BlockStatus::BLOCK_OFF;
+        }
+        model->setUnit(row, state);
     }
 }
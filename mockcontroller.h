@@ -8,8 +8,10 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <cstdlib>
 #include <ctime>
+#include <vector>
 #include "controllerwidget.h"
 
 /**
@@ -20,6 +22,16 @@ class MockController : public QObject {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Shortest simulated delay before a command is answered, in milliseconds.
+     */
+    static constexpr int MIN_ACK_LATENCY_MS = 20;
+
+    /**
+     * @brief Longest simulated delay before a command is answered, in milliseconds.
+     */
+    static constexpr int MAX_ACK_LATENCY_MS = 150;
+
     /**
      * @brief Constructor.
      * @param widget The ControllerWidget this controller manages.
@@ -27,6 +39,22 @@ public:
      */
     explicit MockController(ControllerWidget* widget, QObject* parent = nullptr);
 
+    /**
+     * @brief Generates a temperature reading the way the simulation does.
+     * @param target Desired temperature in Celsius.
+     */
+    static double sampleTemperature(double target);
+
+    /**
+     * @brief Generates a humidity reading the way the simulation does.
+     */
+    static double sampleHumidity();
+
+    /**
+     * @brief Generates a pressure reading the way the simulation does.
+     */
+    static double samplePressure();
+
 public slots:
     /**
      * @brief Handles system start request.
@@ -38,8 +66,20 @@ public slots:
      */
     void onTurnOff();
 
+    /**
+     * @brief Sets the number of simulated units added after the widget's blocks.
+     * @param count Number of additional units.
+     */
+    void setFleetSize(int count);
+
 private slots:
 
+    /**
+     * @brief Starts handling a command after a simulated network delay.
+     * @param command Command sent by the widget.
+     */
+    void onCommand(const ControllerCommand &command);
+
     /**
      * @brief Handles desired temperature change.
      * @param value New desired temperature.
@@ -57,9 +97,34 @@ private slots:
      */
     void simulateStep();
 
+    /**
+     * @brief Performs a simulation step for every additional unit.
+     */
+    void simulateFleetStep();
+
 private:
+    /**
+     * @brief Applies a command and acknowledges it, or simulates a rejection or a lost answer.
+     * @param command Command sent by the widget.
+     */
+    void applyCommand(const ControllerCommand &command);
+
+    /**
+     * @brief Applies a command to one of the additional units.
+     * @param unit Unit index in the unit model.
+     * @param action Command.
+     * @param value Temperature in Celsius or AirFlowDirection index.
+     * @return false if the unit is not simulated by this controller.
+     */
+    bool applyFleetCommand(int unit, ScheduleAction action, int value);
+
     ControllerWidget* widget;  ///< The widget being controlled.
     QTimer simulationTimer;    ///< Timer to trigger periodic simulation updates.
+    QElapsedTimer tickClock;   ///< Time since the previous simulation step, for tick lag.
+    QTimer fleetTimer;         ///< Timer to trigger periodic updates of the additional units.
+    int fleetSize = 0;         ///< Number of additional simulated units.
+    std::vector<double> fleetTargets; ///< Desired temperature of each additional unit.
+    std::vector<bool> fleetPowered;   ///< Whether each additional unit is switched on.
     bool running = false;      ///< Whether the system is active.
     double currentTemperature = 22.0; ///< Target temperature.
 };
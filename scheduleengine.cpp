@@ -0,0 +1,164 @@
+#include "scheduleengine.h"
+
+#include <QDateTime>
+
+namespace {
+
+const char *actionNames[] = {"on", "off", "temperature", "airflow"};
+
+}
+
+ScheduleEngine::ScheduleEngine(QObject *parent)
+    : QObject(parent), wheel(static_cast<quint64>(QDateTime::currentSecsSinceEpoch()))
+{
+    timer.setInterval(1000);
+    connect(&timer, &QTimer::timeout, this, &ScheduleEngine::tick);
+    timer.start();
+}
+
+int ScheduleEngine::addEntry(const ScheduleEntry &entry) {
+    int id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else {
+        id = static_cast<int>(entries.size());
+        entries.emplace_back();
+    }
+
+    Slot &slot = entries[id];
+    slot.entry = entry;
+    slot.used = true;
+    ++count;
+
+    scheduleNext(id, static_cast<qint64>(wheel.currentTick()));
+    return id;
+}
+
+bool ScheduleEngine::removeEntry(int id) {
+    if (id < 0 || id >= static_cast<int>(entries.size()) || !entries[id].used)
+        return false;
+
+    Slot &slot = entries[id];
+    slot.used = false;
+    ++slot.generation;
+    freeIds.push_back(id);
+    --count;
+    return true;
+}
+
+void ScheduleEngine::clear() {
+    freeIds.clear();
+    for (int id = static_cast<int>(entries.size()) - 1; id >= 0; --id) {
+        if (entries[id].used) {
+            entries[id].used = false;
+            ++entries[id].generation;
+        }
+        freeIds.push_back(id);
+    }
+    count = 0;
+}
+
+QVector<int> ScheduleEngine::entryIds() const {
+    QVector<int> ids;
+    ids.reserve(count);
+    for (int id = 0; id < static_cast<int>(entries.size()); ++id)
+        if (entries[id].used)
+            ids.append(id);
+    return ids;
+}
+
+const ScheduleEntry &ScheduleEngine::entry(int id) const {
+    return entries[id].entry;
+}
+
+int ScheduleEngine::size() const {
+    return count;
+}
+
+quint64 ScheduleEngine::payload(int id) const {
+    return (static_cast<quint64>(entries[id].generation) << 32) | static_cast<quint32>(id);
+}
+
+void ScheduleEngine::scheduleNext(int id, qint64 afterSecs) {
+    const ScheduleEntry &entry = entries[id].entry;
+    if ((entry.days & 0x7F) == 0 || !entry.time.isValid())
+        return;
+
+    const QDate start = QDateTime::fromSecsSinceEpoch(afterSecs).date();
+    for (int day = 0; day <= 7; ++day) {
+        const QDate date = start.addDays(day);
+        if (!(entry.days & (1 << (date.dayOfWeek() - 1))))
+            continue;
+
+        const qint64 at = QDateTime(date, entry.time).toSecsSinceEpoch();
+        if (at > afterSecs) {
+            wheel.schedule(static_cast<quint64>(at), payload(id));
+            return;
+        }
+    }
+}
+
+void ScheduleEngine::tick() {
+    const quint64 now = static_cast<quint64>(QDateTime::currentSecsSinceEpoch());
+
+    std::vector<quint64> fired;
+    wheel.advance(now, fired);
+    if (fired.empty())
+        return;
+
+    QVector<ScheduledCommand> commands;
+    commands.reserve(static_cast<int>(fired.size()));
+
+    for (quint64 value : fired) {
+        const int id = static_cast<int>(value & 0xFFFFFFFFu);
+        const quint32 generation = static_cast<quint32>(value >> 32);
+        if (id >= static_cast<int>(entries.size()) || !entries[id].used || entries[id].generation != generation)
+            continue;
+
+        const ScheduleEntry &entry = entries[id].entry;
+        commands.append({entry.unit, entry.action, entry.value});
+        scheduleNext(id, static_cast<qint64>(wheel.currentTick()));
+    }
+
+    if (!commands.isEmpty())
+        emit commandsDue(commands);
+}
+
+void ScheduleEngine::writeXml(QXmlStreamWriter &xml) const {
+    xml.writeStartElement("Schedule");
+    for (int id : entryIds()) {
+        const ScheduleEntry &entry = entries[id].entry;
+        xml.writeEmptyElement("Entry");
+        xml.writeAttribute("unit", QString::number(entry.unit));
+        xml.writeAttribute("days", QString::number(entry.days));
+        xml.writeAttribute("time", entry.time.toString("HH:mm"));
+        xml.writeAttribute("action", actionNames[static_cast<int>(entry.action)]);
+        xml.writeAttribute("value", QString::number(entry.value));
+    }
+    xml.writeEndElement();
+}
+
+void ScheduleEngine::readXml(QXmlStreamReader &xml) {
+    clear();
+
+    while (xml.readNextStartElement()) {
+        if (xml.name() == QString("Entry")) {
+            const QXmlStreamAttributes attributes = xml.attributes();
+            ScheduleEntry entry;
+            entry.unit = attributes.value("unit").toInt();
+            entry.days = static_cast<quint8>(attributes.value("days").toInt());
+            entry.time = QTime::fromString(attributes.value("time").toString(), "HH:mm");
+            entry.value = attributes.value("value").toInt();
+
+            const QString action = attributes.value("action").toString();
+            for (int i = 0; i < 4; ++i)
+                if (action == actionNames[i])
+                    entry.action = static_cast<ScheduleAction>(i);
+
+            addEntry(entry);
+        }
+        xml.skipCurrentElement();
+    }
+}
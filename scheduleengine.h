@@ -0,0 +1,160 @@
+#ifndef SCHEDULEENGINE_H
+#define SCHEDULEENGINE_H
+
+/**
+ * @file scheduleengine.h
+ * @brief Defines the weekly setpoint and mode schedule for units.
+ */
+
+#include <QObject>
+#include <QTimer>
+#include <QTime>
+#include <QVector>
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+#include <vector>
+#include "timerwheel.h"
+
+/**
+ * @enum ScheduleAction
+ * @brief Command issued by a schedule entry.
+ */
+enum class ScheduleAction {
+    TURN_ON,          ///< Turn the unit on
+    TURN_OFF,         ///< Turn the unit off
+    SET_TEMPERATURE,  ///< Change the desired temperature
+    SET_AIRFLOW       ///< Change the airflow direction
+};
+
+/**
+ * @struct ScheduleEntry
+ * @brief A weekly recurring command.
+ */
+struct ScheduleEntry {
+    int unit = 0;                                    ///< Target unit; 0 and any other unit below ControllerWidget::BLOCK_COUNT address the whole local system.
+    quint8 days = 0x7F;                              ///< Weekdays bit mask, bit 0 = Monday ... bit 6 = Sunday.
+    QTime time = QTime(0, 0);                        ///< Local time of day at which the command is issued.
+    ScheduleAction action = ScheduleAction::TURN_ON; ///< Command to issue.
+    int value = 0;                                   ///< Temperature in Celsius or AirFlowDirection index.
+};
+
+/**
+ * @struct ScheduledCommand
+ * @brief A command issued by the schedule.
+ */
+struct ScheduledCommand {
+    int unit = 0;                                    ///< Target unit.
+    ScheduleAction action = ScheduleAction::TURN_ON; ///< Command.
+    int value = 0;                                   ///< Temperature in Celsius or AirFlowDirection index.
+};
+
+/**
+ * @class ScheduleEngine
+ * @brief Issues weekly scheduled commands for many units from a single timer.
+ *
+ * Every entry keeps exactly one pending occurrence in a TimerWheel ticking
+ * once per second. Occurrences that fall due in the same tick are delivered
+ * together in one commandsDue() batch.
+ */
+class ScheduleEngine : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor. The engine starts ticking immediately.
+     * @param parent Optional parent.
+     */
+    explicit ScheduleEngine(QObject *parent = nullptr);
+
+    /**
+     * @brief Adds an entry.
+     * @param entry Entry to add. Entries without any weekday never fire.
+     * @return Identifier of the entry.
+     */
+    int addEntry(const ScheduleEntry &entry);
+
+    /**
+     * @brief Removes an entry.
+     * @param id Identifier returned by addEntry().
+     * @return false if no such entry exists.
+     */
+    bool removeEntry(int id);
+
+    /**
+     * @brief Removes all entries.
+     */
+    void clear();
+
+    /**
+     * @brief Returns the identifiers of all entries in ascending order.
+     */
+    QVector<int> entryIds() const;
+
+    /**
+     * @brief Returns an entry.
+     * @param id Identifier returned by addEntry().
+     */
+    const ScheduleEntry &entry(int id) const;
+
+    /**
+     * @brief Returns the number of entries.
+     */
+    int size() const;
+
+    /**
+     * @brief Writes all entries as a \<Schedule\> element.
+     * @param xml Writer positioned inside the settings document.
+     */
+    void writeXml(QXmlStreamWriter &xml) const;
+
+    /**
+     * @brief Replaces all entries with those of a \<Schedule\> element.
+     * @param xml Reader positioned at the start of the \<Schedule\> element.
+     */
+    void readXml(QXmlStreamReader &xml);
+
+signals:
+    /**
+     * @brief Emitted once per tick with every command that fell due.
+     * @param commands Commands in the order they became due.
+     */
+    void commandsDue(const QVector<ScheduledCommand> &commands);
+
+private slots:
+    /**
+     * @brief Advances the wheel to the current time and emits due commands.
+     */
+    void tick();
+
+private:
+    /**
+     * @struct Slot
+     * @brief Storage of an entry.
+     */
+    struct Slot {
+        ScheduleEntry entry;     ///< The entry.
+        quint32 generation = 0;  ///< Incremented on removal so stale wheel timers are ignored.
+        bool used = false;       ///< Whether the slot holds an entry.
+    };
+
+    /**
+     * @brief Schedules the next occurrence of an entry after a given second.
+     * @param id Identifier of the entry.
+     * @param afterSecs Seconds since the epoch; the occurrence is strictly later.
+     */
+    void scheduleNext(int id, qint64 afterSecs);
+
+    /**
+     * @brief Packs an entry identifier and generation into a wheel payload.
+     * @param id Identifier of the entry.
+     */
+    quint64 payload(int id) const;
+
+    std::vector<Slot> entries; ///< Entries indexed by identifier.
+    std::vector<int> freeIds;  ///< Identifiers available for reuse.
+    TimerWheel wheel;          ///< Pending occurrences keyed by seconds since the epoch.
+    QTimer timer;              ///< One-second tick.
+    int count = 0;             ///< Number of entries.
+};
+
+#endif // SCHEDULEENGINE_H
@@ -0,0 +1,237 @@
+#include "sensorhistory.h"
+
+#include <QtAlgorithms>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+quint64 toBits(double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(quint64 bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+qint64 signExtend(quint64 value, int count) {
+    const quint64 sign = quint64(1) << (count - 1);
+    return static_cast<qint64>((value ^ sign) - sign);
+}
+
+}
+
+void BitWriter::write(quint64 value, int count) {
+    if (count < 64)
+        value &= (quint64(1) << count) - 1;
+
+    const int offset = static_cast<int>(bits % 64);
+    if (offset == 0)
+        buffer.push_back(0);
+
+    const int free = 64 - offset;
+    if (count <= free) {
+        buffer.back() |= value << (free - count);
+    }
+    else {
+        const int rest = count - free;
+        buffer.back() |= value >> rest;
+        buffer.push_back(value << (64 - rest));
+    }
+    bits += count;
+}
+
+quint64 BitReader::read(int count) {
+    const size_t word = static_cast<size_t>(position / 64);
+    const int offset = static_cast<int>(position % 64);
+    const int available = 64 - offset;
+
+    quint64 result = ((*buffer)[word] << offset) >> (64 - count);
+    if (count > available) {
+        const int rest = count - available;
+        result |= (*buffer)[word + 1] >> (64 - rest);
+    }
+    position += count;
+    return result;
+}
+
+bool HistoryChunk::append(qint64 timestampMs, double value) {
+    if (isFull() || (count > 0 && timestampMs < lastTs))
+        return false;
+
+    const quint64 valueBits = toBits(value);
+
+    if (count == 0) {
+        bits.write(static_cast<quint64>(timestampMs), 64);
+        bits.write(valueBits, 64);
+        firstTs = timestampMs;
+    }
+    else {
+        const qint64 delta = timestampMs - lastTs;
+        const qint64 deltaOfDelta = delta - lastDelta;
+        const quint64 encoded = static_cast<quint64>(deltaOfDelta);
+
+        if (deltaOfDelta == 0) {
+            bits.write(0b0, 1);
+        }
+        else if (deltaOfDelta >= -64 && deltaOfDelta < 64) {
+            bits.write(0b10, 2);
+            bits.write(encoded, 7);
+        }
+        else if (deltaOfDelta >= -256 && deltaOfDelta < 256) {
+            bits.write(0b110, 3);
+            bits.write(encoded, 9);
+        }
+        else if (deltaOfDelta >= -2048 && deltaOfDelta < 2048) {
+            bits.write(0b1110, 4);
+            bits.write(encoded, 12);
+        }
+        else {
+            bits.write(0b1111, 4);
+            bits.write(encoded, 64);
+        }
+        lastDelta = delta;
+
+        const quint64 xored = valueBits ^ lastValueBits;
+        if (xored == 0) {
+            bits.write(0b0, 1);
+        }
+        else {
+            const int leading = std::min<int>(qCountLeadingZeroBits(xored), 31);
+            const int trailing = qCountTrailingZeroBits(xored);
+
+            if (lastLeading >= 0 && leading >= lastLeading
+                && trailing >= 64 - lastLeading - lastMeaningful) {
+                bits.write(0b10, 2);
+                bits.write(xored >> (64 - lastLeading - lastMeaningful), lastMeaningful);
+            }
+            else {
+                const int meaningful = 64 - leading - trailing;
+                bits.write(0b11, 2);
+                bits.write(static_cast<quint64>(leading), 5);
+                bits.write(static_cast<quint64>(meaningful == 64 ? 0 : meaningful), 6);
+                bits.write(xored >> trailing, meaningful);
+                lastLeading = leading;
+                lastMeaningful = meaningful;
+            }
+        }
+    }
+
+    lastTs = timestampMs;
+    lastValueBits = valueBits;
+    minVal = std::min(minVal, value);
+    maxVal = std::max(maxVal, value);
+    ++count;
+    return true;
+}
+
+HistoryChunk::Reader::Reader(const HistoryChunk &chunk)
+    : bits(chunk.bits.words(), chunk.bits.bitCount()), left(chunk.count)
+{
+}
+
+bool HistoryChunk::Reader::next(HistorySample &sample) {
+    if (left == 0)
+        return false;
+
+    if (decoded == 0) {
+        timestamp = static_cast<qint64>(bits.read(64));
+        valueBits = bits.read(64);
+    }
+    else {
+        qint64 deltaOfDelta = 0;
+        if (!bits.readBit())
+            deltaOfDelta = 0;
+        else if (!bits.readBit())
+            deltaOfDelta = signExtend(bits.read(7), 7);
+        else if (!bits.readBit())
+            deltaOfDelta = signExtend(bits.read(9), 9);
+        else if (!bits.readBit())
+            deltaOfDelta = signExtend(bits.read(12), 12);
+        else
+            deltaOfDelta = static_cast<qint64>(bits.read(64));
+
+        delta += deltaOfDelta;
+        timestamp += delta;
+
+        if (bits.readBit()) {
+            if (bits.readBit()) {
+                leading = static_cast<int>(bits.read(5));
+                meaningful = static_cast<int>(bits.read(6));
+                if (meaningful == 0)
+                    meaningful = 64;
+            }
+            valueBits ^= bits.read(meaningful) << (64 - leading - meaningful);
+        }
+    }
+
+    sample.timestampMs = timestamp;
+    sample.value = fromBits(valueBits);
+    ++decoded;
+    --left;
+    return true;
+}
+
+bool HistorySeries::append(qint64 timestampMs, double value) {
+    if (!chunks.empty() && timestampMs < chunks.back().lastTimestamp())
+        return false;
+    if (chunks.empty() || chunks.back().isFull())
+        chunks.emplace_back();
+    return chunks.back().append(timestampMs, value);
+}
+
+bool HistorySeries::minMax(qint64 fromMs, qint64 toMs, double &minValue, double &maxValue) const {
+    bool found = false;
+    minValue = std::numeric_limits<double>::infinity();
+    maxValue = -std::numeric_limits<double>::infinity();
+
+    for (const HistoryChunk &chunk : chunks) {
+        if (chunk.lastTimestamp() < fromMs || chunk.firstTimestamp() > toMs)
+            continue;
+
+        if (chunk.firstTimestamp() >= fromMs && chunk.lastTimestamp() <= toMs) {
+            minValue = std::min(minValue, chunk.minValue());
+            maxValue = std::max(maxValue, chunk.maxValue());
+            found = true;
+            continue;
+        }
+
+        HistoryChunk::Reader reader = chunk.reader();
+        HistorySample sample;
+        while (reader.next(sample)) {
+            if (sample.timestampMs > toMs)
+                break;
+            if (sample.timestampMs < fromMs)
+                continue;
+            minValue = std::min(minValue, sample.value);
+            maxValue = std::max(maxValue, sample.value);
+            found = true;
+        }
+    }
+    return found;
+}
+
+void HistorySeries::dropBefore(qint64 cutoffMs) {
+    auto end = chunks.begin();
+    while (end != chunks.end() && end->isFull() && end->lastTimestamp() < cutoffMs)
+        ++end;
+    chunks.erase(chunks.begin(), end);
+}
+
+qint64 HistorySeries::size() const {
+    qint64 total = 0;
+    for (const HistoryChunk &chunk : chunks)
+        total += chunk.size();
+    return total;
+}
+
+qint64 HistorySeries::byteSize() const {
+    qint64 total = 0;
+    for (const HistoryChunk &chunk : chunks)
+        total += chunk.byteSize();
+    return total;
+}
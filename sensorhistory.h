@@ -0,0 +1,296 @@
+#ifndef SENSORHISTORY_H
+#define SENSORHISTORY_H
+
+/**
+ * @file sensorhistory.h
+ * @brief Defines compressed storage for long-term sensor history.
+ *
+ * Samples are packed in the Gorilla style: timestamps as delta-of-delta,
+ * values as the XOR with the previous value. Slowly changing readings taken
+ * at a regular interval shrink to a few bits per sample.
+ */
+
+#include <QtGlobal>
+#include <vector>
+#include <limits>
+
+/**
+ * @struct HistorySample
+ * @brief A single timestamped reading.
+ */
+struct HistorySample {
+    qint64 timestampMs = 0; ///< Milliseconds since the Unix epoch.
+    double value = 0.0;     ///< Reading.
+};
+
+/**
+ * @class BitWriter
+ * @brief Appends bit fields to a growing buffer of 64-bit words.
+ */
+class BitWriter {
+public:
+    /**
+     * @brief Appends the lowest bits of a value, most significant first.
+     * @param value Bits to write.
+     * @param count Number of bits, 1 to 64.
+     */
+    void write(quint64 value, int count);
+
+    /**
+     * @brief Returns the number of bits written.
+     */
+    qint64 bitCount() const { return bits; }
+
+    /**
+     * @brief Returns the underlying words.
+     */
+    const std::vector<quint64> &words() const { return buffer; }
+
+private:
+    std::vector<quint64> buffer; ///< Packed bits.
+    qint64 bits = 0;             ///< Number of valid bits.
+};
+
+/**
+ * @class BitReader
+ * @brief Reads bit fields written by BitWriter.
+ */
+class BitReader {
+public:
+    /**
+     * @brief Constructor.
+     * @param words Buffer to read from. Must outlive the reader.
+     * @param bitCount Number of valid bits in the buffer.
+     */
+    BitReader(const std::vector<quint64> &words, qint64 bitCount) : buffer(&words), bits(bitCount) {}
+
+    /**
+     * @brief Reads a bit field.
+     * @param count Number of bits, 1 to 64.
+     */
+    quint64 read(int count);
+
+    /**
+     * @brief Reads a single bit.
+     */
+    bool readBit() { return read(1) != 0; }
+
+    /**
+     * @brief Returns the number of unread bits.
+     */
+    qint64 remaining() const { return bits - position; }
+
+private:
+    const std::vector<quint64> *buffer; ///< Packed bits.
+    qint64 bits;                        ///< Number of valid bits.
+    qint64 position = 0;                ///< Index of the next bit.
+};
+
+/**
+ * @class HistoryChunk
+ * @brief A block of compressed samples with a min/max summary.
+ *
+ * Samples must be appended in non-decreasing timestamp order. A chunk holds
+ * at most MAX_SAMPLES samples so range queries can skip it as a whole.
+ */
+class HistoryChunk {
+public:
+    /**
+     * @brief Maximum number of samples in one chunk.
+     */
+    static constexpr int MAX_SAMPLES = 1024;
+
+    /**
+     * @class Reader
+     * @brief Streaming decoder over the samples of a chunk.
+     */
+    class Reader {
+    public:
+        /**
+         * @brief Constructor.
+         * @param chunk Chunk to decode. Must outlive the reader and not be appended to meanwhile.
+         */
+        explicit Reader(const HistoryChunk &chunk);
+
+        /**
+         * @brief Decodes the next sample.
+         * @param sample Receives the sample.
+         * @return false when the chunk is exhausted.
+         */
+        bool next(HistorySample &sample);
+
+    private:
+        BitReader bits;         ///< Position in the encoded stream.
+        int left;               ///< Samples still to decode.
+        int decoded = 0;        ///< Samples decoded so far.
+        qint64 timestamp = 0;   ///< Previous timestamp.
+        qint64 delta = 0;       ///< Previous timestamp delta.
+        quint64 valueBits = 0;  ///< Previous value as raw bits.
+        int leading = 0;        ///< Leading zeros of the current XOR window.
+        int meaningful = 0;     ///< Width of the current XOR window.
+    };
+
+    /**
+     * @brief Appends a sample.
+     * @param timestampMs Timestamp, not earlier than the previous one.
+     * @param value Reading.
+     * @return false if the chunk is full or the timestamp goes backwards.
+     */
+    bool append(qint64 timestampMs, double value);
+
+    /**
+     * @brief Returns a decoder positioned at the first sample.
+     */
+    Reader reader() const { return Reader(*this); }
+
+    /**
+     * @brief Returns the number of samples.
+     */
+    int size() const { return count; }
+
+    /**
+     * @brief Returns whether no more samples can be appended.
+     */
+    bool isFull() const { return count >= MAX_SAMPLES; }
+
+    /**
+     * @brief Returns the timestamp of the first sample.
+     */
+    qint64 firstTimestamp() const { return firstTs; }
+
+    /**
+     * @brief Returns the timestamp of the last sample.
+     */
+    qint64 lastTimestamp() const { return lastTs; }
+
+    /**
+     * @brief Returns the smallest value in the chunk.
+     */
+    double minValue() const { return minVal; }
+
+    /**
+     * @brief Returns the largest value in the chunk.
+     */
+    double maxValue() const { return maxVal; }
+
+    /**
+     * @brief Returns the size of the encoded stream in bytes.
+     */
+    qint64 byteSize() const { return (bits.bitCount() + 7) / 8; }
+
+private:
+    BitWriter bits;              ///< Encoded stream.
+    int count = 0;               ///< Number of samples.
+    qint64 firstTs = 0;          ///< Timestamp of the first sample.
+    qint64 lastTs = 0;           ///< Timestamp of the last sample.
+    qint64 lastDelta = 0;        ///< Delta between the last two timestamps.
+    quint64 lastValueBits = 0;   ///< Last value as raw bits.
+    int lastLeading = -1;        ///< Leading zeros of the current XOR window, -1 if none yet.
+    int lastMeaningful = 0;      ///< Width of the current XOR window.
+    double minVal = std::numeric_limits<double>::infinity();  ///< Smallest value.
+    double maxVal = -std::numeric_limits<double>::infinity(); ///< Largest value.
+};
+
+/**
+ * @class HistorySeries
+ * @brief An append-only sequence of chunks for one sensor.
+ */
+class HistorySeries {
+public:
+    /**
+     * @brief Appends a sample, starting a new chunk when the current one is full.
+     * @param timestampMs Timestamp, not earlier than the previous one.
+     * @param value Reading.
+     * @return false if the timestamp goes backwards.
+     */
+    bool append(qint64 timestampMs, double value);
+
+    /**
+     * @brief Calls a function for every sample in a time range.
+     *
+     * Chunks entirely outside the range are skipped without decoding.
+     *
+     * @param fromMs Start of the range, inclusive.
+     * @param toMs End of the range, inclusive.
+     * @param fn Callable taking a const HistorySample&.
+     */
+    template <typename Fn>
+    void forEachInRange(qint64 fromMs, qint64 toMs, Fn fn) const {
+        forEachInRange(fromMs, toMs, -std::numeric_limits<double>::infinity(),
+                       std::numeric_limits<double>::infinity(), fn);
+    }
+
+    /**
+     * @brief Calls a function for every sample in a time range whose value is within bounds.
+     *
+     * Chunks whose time range or min/max summary does not intersect the query
+     * are skipped without decoding.
+     *
+     * @param fromMs Start of the range, inclusive.
+     * @param toMs End of the range, inclusive.
+     * @param minValue Smallest accepted value.
+     * @param maxValue Largest accepted value.
+     * @param fn Callable taking a const HistorySample&.
+     */
+    template <typename Fn>
+    void forEachInRange(qint64 fromMs, qint64 toMs, double minValue, double maxValue, Fn fn) const {
+        for (const HistoryChunk &chunk : chunks) {
+            if (chunk.lastTimestamp() < fromMs || chunk.firstTimestamp() > toMs)
+                continue;
+            if (chunk.maxValue() < minValue || chunk.minValue() > maxValue)
+                continue;
+
+            HistoryChunk::Reader reader = chunk.reader();
+            HistorySample sample;
+            while (reader.next(sample)) {
+                if (sample.timestampMs > toMs)
+                    break;
+                if (sample.timestampMs >= fromMs && sample.value >= minValue && sample.value <= maxValue)
+                    fn(sample);
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the smallest and largest value in a time range.
+     *
+     * Chunks fully inside the range are answered from their summary.
+     *
+     * @param fromMs Start of the range, inclusive.
+     * @param toMs End of the range, inclusive.
+     * @param minValue Receives the smallest value.
+     * @param maxValue Receives the largest value.
+     * @return false if the range contains no samples.
+     */
+    bool minMax(qint64 fromMs, qint64 toMs, double &minValue, double &maxValue) const;
+
+    /**
+     * @brief Drops full chunks whose samples are all older than a cutoff.
+     *
+     * The chunk being appended to is always kept, so retention works in whole
+     * chunks and a few samples older than the cutoff may remain.
+     *
+     * @param cutoffMs Oldest timestamp to keep.
+     */
+    void dropBefore(qint64 cutoffMs);
+
+    /**
+     * @brief Returns the chunks of the series.
+     */
+    const std::vector<HistoryChunk> &chunkList() const { return chunks; }
+
+    /**
+     * @brief Returns the total number of samples.
+     */
+    qint64 size() const;
+
+    /**
+     * @brief Returns the total encoded size in bytes.
+     */
+    qint64 byteSize() const;
+
+private:
+    std::vector<HistoryChunk> chunks; ///< Chunks in timestamp order.
+};
+
+#endif // SENSORHISTORY_H
@@ -0,0 +1,349 @@
+#include "sharedstatetable.h"
+#include "unittablemodel.h"
+#include "telemetrythrottle.h"
+
+#include <QDebug>
+#include <QDir>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+const char *sharedKey = "AirConditioningApp.SharedState";
+const quint32 sharedMagic = 0x41435354;  // "ACST"
+const quint32 sharedLayoutVersion = 3;
+const int minimumCapacity = 64;
+const int maxReadAttempts = 4;
+const int maxGenerationAttempts = 16;
+
+QString tableKey(quint32 generation) {
+    return QString("%1.%2").arg(sharedKey).arg(generation);
+}
+
+quint64 toBits(double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(quint64 bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+}
+
+/**
+ * @struct SharedDirectory
+ * @brief Contents of the directory segment, which has a fixed key.
+ */
+struct SharedDirectory {
+    quint32 magic;                    ///< sharedMagic once the directory is initialized.
+    quint32 layoutVersion;            ///< sharedLayoutVersion.
+    std::atomic<quint32> generation;  ///< Generation of the current table segment, 0 while there is none.
+};
+
+/**
+ * @struct SharedTableHeader
+ * @brief Start of a table segment.
+ */
+struct SharedTableHeader {
+    quint32 magic;                      ///< sharedMagic once the table is initialized.
+    quint32 layoutVersion;              ///< sharedLayoutVersion.
+    quint32 capacity;                   ///< Number of records following the header.
+    quint32 generation;                 ///< Generation in the key of this segment.
+    std::atomic<quint32> unitCount;     ///< Number of records in use.
+    std::atomic<quint64> tableVersion;  ///< Incremented after every published batch.
+};
+
+/**
+ * @struct SharedUnitRecord
+ * @brief State of one unit, guarded by a seqlock.
+ *
+ * The sequence is odd while the writer updates the record. Its value also
+ * serves as the unit's version. Fields are relaxed atomics so concurrent
+ * reads are well defined; the sequence check discards torn snapshots.
+ */
+struct SharedUnitRecord {
+    std::atomic<quint32> sequence;        ///< Seqlock counter and version.
+    std::atomic<quint32> airflow;         ///< AirFlowDirection index.
+    std::atomic<quint32> status;          ///< BlockStatus index.
+    std::atomic<quint32> reserved;        ///< Padding.
+    std::atomic<quint64> temperatureBits; ///< Temperature in Celsius as raw bits.
+    std::atomic<quint64> humidityBits;    ///< Humidity percentage as raw bits.
+    std::atomic<quint64> pressureBits;    ///< Pressure in Pascals as raw bits.
+    std::atomic<quint64> setpointBits;    ///< Desired temperature in Celsius as raw bits.
+};
+
+static_assert(std::atomic<quint64>::is_always_lock_free, "The shared table needs lock-free 64-bit atomics");
+
+SharedStateWriter::SharedStateWriter(UnitTableModel *model, QObject *parent)
+    : QObject(parent), model(model), writerLock(QDir::temp().filePath(QString("%1.lock").arg(sharedKey)))
+{
+    // A lock left by a crashed writer is detected as stale and taken over.
+    if (!writerLock.tryLock(0)) {
+        qWarning() << "Another console is already the shared state writer; this console will not publish";
+        return;
+    }
+
+    if (!openDirectory() || !createTable(model->unitCount()))
+        return;
+
+    for (int row = 0; row < model->unitCount(); ++row)
+        publish(row);
+    header->unitCount.store(static_cast<quint32>(model->unitCount()), std::memory_order_release);
+    header->tableVersion.fetch_add(1, std::memory_order_release);
+    directory->generation.store(header->generation, std::memory_order_release);
+
+    connect(model, &QAbstractItemModel::dataChanged, this, &SharedStateWriter::publishRows);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &SharedStateWriter::resizeTable);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, &SharedStateWriter::resizeTable);
+}
+
+bool SharedStateWriter::isAttached() const {
+    return header != nullptr;
+}
+
+bool SharedStateWriter::openDirectory() {
+    directoryMemory.setKey(sharedKey);
+
+    // Holding writerLock, an existing directory can only be left over from a
+    // previous writer, and readers may still map it, so it is reused in place.
+    if (!directoryMemory.create(sizeof(SharedDirectory))
+        && (directoryMemory.error() != QSharedMemory::AlreadyExists || !directoryMemory.attach())) {
+        qWarning() << "Cannot create shared state directory:" << directoryMemory.errorString();
+        return false;
+    }
+    if (directoryMemory.size() < static_cast<qsizetype>(sizeof(SharedDirectory))) {
+        qWarning() << "Shared state directory is too small";
+        directoryMemory.detach();
+        return false;
+    }
+
+    directory = static_cast<SharedDirectory *>(directoryMemory.data());
+    if (directory->magic != sharedMagic || directory->layoutVersion != sharedLayoutVersion) {
+        directory->magic = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        directory->layoutVersion = sharedLayoutVersion;
+        directory->generation.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        directory->magic = sharedMagic;
+    }
+    return true;
+}
+
+bool SharedStateWriter::createTable(int capacity) {
+    int rounded = minimumCapacity;
+    while (rounded < capacity)
+        rounded *= 2;
+
+    const qsizetype size = sizeof(SharedTableHeader) + sizeof(SharedUnitRecord) * static_cast<qsizetype>(rounded);
+
+    // Segments of earlier generations stay alive while readers map them, so
+    // every table gets a key that has not been used yet.
+    quint32 generation = directory->generation.load(std::memory_order_relaxed);
+    bool created = false;
+    for (int attempt = 0; attempt < maxGenerationAttempts && !created; ++attempt) {
+        generation = generation + 1 == 0 ? 1 : generation + 1;
+        memory.setKey(tableKey(generation));
+        created = memory.create(size);
+        if (!created && memory.error() != QSharedMemory::AlreadyExists)
+            break;
+    }
+    if (!created) {
+        qWarning() << "Cannot create shared state table:" << memory.errorString();
+        return false;
+    }
+
+    std::memset(memory.data(), 0, static_cast<size_t>(size));
+    header = static_cast<SharedTableHeader *>(memory.data());
+    records = reinterpret_cast<SharedUnitRecord *>(header + 1);
+    header->layoutVersion = sharedLayoutVersion;
+    header->capacity = static_cast<quint32>(rounded);
+    header->generation = generation;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = sharedMagic;
+    return true;
+}
+
+void SharedStateWriter::publish(int row) {
+    const UnitState &state = model->unit(row);
+    SharedUnitRecord &record = records[row];
+
+    const quint32 sequence = record.sequence.load(std::memory_order_relaxed);
+    record.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    record.airflow.store(static_cast<quint32>(state.airflow), std::memory_order_relaxed);
+    record.status.store(static_cast<quint32>(state.status), std::memory_order_relaxed);
+    record.temperatureBits.store(toBits(state.temperatureC), std::memory_order_relaxed);
+    record.humidityBits.store(toBits(state.humidity), std::memory_order_relaxed);
+    record.pressureBits.store(toBits(state.pressurePa), std::memory_order_relaxed);
+    record.setpointBits.store(toBits(state.setpointC), std::memory_order_relaxed);
+
+    record.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void SharedStateWriter::publishRows(const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+    if (header == nullptr)
+        return;
+
+    const int last = std::min(bottomRight.row(), static_cast<int>(header->capacity) - 1);
+    for (int row = topLeft.row(); row <= last; ++row)
+        publish(row);
+    header->tableVersion.fetch_add(1, std::memory_order_release);
+}
+
+void SharedStateWriter::resizeTable() {
+    if (header == nullptr)
+        return;
+
+    const int count = model->unitCount();
+    if (count > static_cast<int>(header->capacity)) {
+        // Readers keep the old segment alive until they follow the directory
+        // to the new one; this process no longer needs it.
+        header = nullptr;
+        records = nullptr;
+        memory.detach();
+        if (!createTable(count))
+            return;
+    }
+
+    for (int row = 0; row < count; ++row)
+        publish(row);
+    header->unitCount.store(static_cast<quint32>(count), std::memory_order_release);
+    header->tableVersion.fetch_add(1, std::memory_order_release);
+    directory->generation.store(header->generation, std::memory_order_release);
+}
+
+SharedStateReader::SharedStateReader(ControllerWidget *widget, QObject *parent)
+    : QObject(parent), widget(widget)
+{
+    directoryMemory.setKey(sharedKey);
+
+    pollTimer.setInterval(16);
+    connect(&pollTimer, &QTimer::timeout, this, &SharedStateReader::poll);
+    pollTimer.start();
+}
+
+bool SharedStateReader::isAttached() const {
+    return header != nullptr;
+}
+
+bool SharedStateReader::attachDirectory() {
+    if (!directoryMemory.attach(QSharedMemory::ReadOnly))
+        return false;
+
+    const SharedDirectory *candidate = static_cast<const SharedDirectory *>(directoryMemory.constData());
+    if (directoryMemory.size() < static_cast<qsizetype>(sizeof(SharedDirectory)) || candidate->magic != sharedMagic
+        || candidate->layoutVersion != sharedLayoutVersion) {
+        directoryMemory.detach();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    directory = candidate;
+    return true;
+}
+
+bool SharedStateReader::attach(quint32 generation) {
+    memory.setKey(tableKey(generation));
+    if (!memory.attach(QSharedMemory::ReadOnly))
+        return false;
+
+    const SharedTableHeader *candidate = static_cast<const SharedTableHeader *>(memory.constData());
+    if (memory.size() < static_cast<qsizetype>(sizeof(SharedTableHeader)) || candidate->magic != sharedMagic
+        || candidate->layoutVersion != sharedLayoutVersion || candidate->generation != generation
+        || memory.size() < static_cast<qsizetype>(sizeof(SharedTableHeader) + sizeof(SharedUnitRecord) * candidate->capacity)) {
+        memory.detach();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    header = candidate;
+    records = reinterpret_cast<const SharedUnitRecord *>(header + 1);
+    lastTableVersion = 0;
+    lastSequences.assign(header->capacity, 0);
+    return true;
+}
+
+void SharedStateReader::detach() {
+    header = nullptr;
+    records = nullptr;
+    memory.detach();
+}
+
+void SharedStateReader::poll() {
+    if (directory == nullptr && !attachDirectory())
+        return;
+
+    const quint32 generation = directory->generation.load(std::memory_order_acquire);
+    if (header != nullptr && header->generation != generation)
+        detach();
+    if (header == nullptr && (generation == 0 || !attach(generation)))
+        return;
+
+    const quint64 tableVersion = header->tableVersion.load(std::memory_order_acquire);
+    if (tableVersion == lastTableVersion)
+        return;
+    lastTableVersion = tableVersion;
+
+    const int count = static_cast<int>(std::min(header->unitCount.load(std::memory_order_acquire), header->capacity));
+    UnitTableModel *model = widget->unitModel();
+    if (model->unitCount() != std::max(count, ControllerWidget::BLOCK_COUNT))
+        model->resize(std::max(count, ControllerWidget::BLOCK_COUNT));
+
+    TelemetryThrottle *telemetry = widget->telemetryInput();
+
+    for (int row = 0; row < count; ++row) {
+        const SharedUnitRecord &record = records[row];
+        quint32 sequence = record.sequence.load(std::memory_order_acquire);
+        if (sequence == lastSequences[row])
+            continue;
+
+        UnitState state = model->unit(row);
+        bool consistent = false;
+        for (int attempt = 0; attempt < maxReadAttempts && !consistent; ++attempt) {
+            if (sequence & 1) {
+                sequence = record.sequence.load(std::memory_order_acquire);
+                continue;
+            }
+
+            state.airflow = static_cast<AirFlowDirection>(record.airflow.load(std::memory_order_relaxed));
+            state.status = static_cast<BlockStatus>(record.status.load(std::memory_order_relaxed));
+            state.temperatureC = fromBits(record.temperatureBits.load(std::memory_order_relaxed));
+            state.humidity = fromBits(record.humidityBits.load(std::memory_order_relaxed));
+            state.pressurePa = fromBits(record.pressureBits.load(std::memory_order_relaxed));
+            state.setpointC = fromBits(record.setpointBits.load(std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            const quint32 check = record.sequence.load(std::memory_order_relaxed);
+            consistent = check == sequence;
+            sequence = check;
+        }
+
+        if (!consistent) {
+            // The writer is mid-update; force another pass on the next poll.
+            lastTableVersion = 0;
+            continue;
+        }
+        lastSequences[row] = sequence;
+
+        if (row >= ControllerWidget::BLOCK_COUNT) {
+            model->setUnit(row, state);
+            continue;
+        }
+
+        if (row == 0) {
+            telemetry->submit(TelemetryChannel::TEMPERATURE, state.temperatureC);
+            telemetry->submit(TelemetryChannel::HUMIDITY, state.humidity);
+            telemetry->submit(TelemetryChannel::PRESSURE, state.pressurePa);
+            telemetry->submit(TelemetryChannel::AIRFLOW, static_cast<int>(state.airflow));
+        }
+        const TelemetryChannel statusChannel = static_cast<TelemetryChannel>(
+            static_cast<int>(TelemetryChannel::BLOCK1_STATUS) + row);
+        telemetry->submit(statusChannel, static_cast<int>(state.status));
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef SHAREDSTATETABLE_H
+#define SHAREDSTATETABLE_H
+
+/**
+ * @file sharedstatetable.h
+ * @brief Defines a shared-memory table through which several consoles share one backend feed.
+ *
+ * One writer process publishes the state of every unit; any number of reader
+ * processes map the same memory and redraw only the units whose version
+ * changed. Each record is guarded by a sequence counter (a seqlock), so
+ * readers never block the writer and never see a half-written record.
+ *
+ * The table lives in a segment whose key carries a generation number. A
+ * small directory segment with a fixed key publishes the current
+ * generation, so the writer can grow the table into a new segment while
+ * readers still map the old one, and readers follow it on their next poll.
+ */
+
+#include <QObject>
+#include <QSharedMemory>
+#include <QLockFile>
+#include <QTimer>
+#include <QModelIndex>
+#include <vector>
+#include "controllerwidget.h"
+
+/**
+ * @enum SharedFeedMode
+ * @brief How a console obtains unit state.
+ */
+enum class SharedFeedMode {
+    LOCAL,   ///< Own backend, nothing shared
+    WRITER,  ///< Own simulated backend, published to the shared table
+    READER   ///< State read from the shared table
+};
+
+struct SharedDirectory;
+struct SharedTableHeader;
+struct SharedUnitRecord;
+
+/**
+ * @class SharedStateWriter
+ * @brief Publishes the rows of a UnitTableModel to the shared table.
+ *
+ * Rows are published when the model announces them with dataChanged(), so
+ * the table is written at most once per frame per unit. Only one writer may
+ * exist per host; it is elected with a lock file, and a second writer stays
+ * detached instead of touching the live table.
+ */
+class SharedStateWriter : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor. Creates the shared table sized for the current model.
+     * @param model Model whose rows are published.
+     * @param parent Optional parent.
+     */
+    explicit SharedStateWriter(UnitTableModel *model, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns whether the shared table could be created.
+     */
+    bool isAttached() const;
+
+private slots:
+    /**
+     * @brief Publishes a range of changed rows.
+     * @param topLeft First changed index.
+     * @param bottomRight Last changed index.
+     */
+    void publishRows(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+
+    /**
+     * @brief Updates the unit count after rows were inserted or removed, growing the table if needed.
+     */
+    void resizeTable();
+
+private:
+    /**
+     * @brief Creates or takes over the directory segment.
+     * @return false on failure.
+     */
+    bool openDirectory();
+
+    /**
+     * @brief Creates a table segment for a number of units under the next free generation and publishes it.
+     * @param capacity Number of records.
+     * @return false on failure.
+     */
+    bool createTable(int capacity);
+
+    /**
+     * @brief Writes one unit into its record.
+     * @param row Unit index.
+     */
+    void publish(int row);
+
+    UnitTableModel *model;                 ///< Published model.
+    QLockFile writerLock;                  ///< Held while this process is the writer.
+    QSharedMemory directoryMemory;         ///< Directory segment.
+    SharedDirectory *directory = nullptr;  ///< Directory inside its shared memory.
+    QSharedMemory memory;                  ///< Shared table of the current generation.
+    SharedTableHeader *header = nullptr;   ///< Table header inside the shared memory.
+    SharedUnitRecord *records = nullptr;   ///< Unit records inside the shared memory.
+};
+
+/**
+ * @class SharedStateReader
+ * @brief Polls the shared table once per frame and feeds changed units to ControllerWidget.
+ *
+ * Units shown in the graphics scene go through the widget's TelemetryThrottle,
+ * all others are written straight to the unit model.
+ */
+class SharedStateReader : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor. Attaches to the shared table, retrying until a writer creates it.
+     * @param widget The widget being fed.
+     * @param parent Optional parent.
+     */
+    explicit SharedStateReader(ControllerWidget *widget, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns whether the reader is attached to the shared table.
+     */
+    bool isAttached() const;
+
+private slots:
+    /**
+     * @brief Reads every unit whose version changed since the previous poll.
+     */
+    void poll();
+
+private:
+    /**
+     * @brief Attaches to the directory segment and validates it.
+     * @return false if no writer has created it yet.
+     */
+    bool attachDirectory();
+
+    /**
+     * @brief Attaches to the table segment of a generation and validates its header.
+     * @param generation Generation published in the directory.
+     * @return false if no valid table exists yet.
+     */
+    bool attach(quint32 generation);
+
+    /**
+     * @brief Detaches from the table segment.
+     */
+    void detach();
+
+    ControllerWidget *widget;                 ///< The widget being fed.
+    QSharedMemory directoryMemory;            ///< Directory segment.
+    const SharedDirectory *directory = nullptr; ///< Directory inside its shared memory.
+    QSharedMemory memory;                     ///< Shared table of the attached generation.
+    const SharedTableHeader *header = nullptr; ///< Table header inside the shared memory.
+    const SharedUnitRecord *records = nullptr; ///< Unit records inside the shared memory.
+    quint64 lastTableVersion = 0;             ///< Table version seen at the previous poll.
+    std::vector<quint32> lastSequences;       ///< Sequence seen for each unit at the previous poll.
+    QTimer pollTimer;                         ///< Per-frame poll timer.
+};
+
+#endif // SHAREDSTATETABLE_H
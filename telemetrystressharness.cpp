@@ -0,0 +1,163 @@
+#include "telemetrystressharness.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+const int generatorIntervalMs = 5;
+const int heartbeatIntervalMs = 10;
+
+}
+
+TelemetryStressHarness::TelemetryStressHarness(ControllerWidget *widget, QObject *parent)
+    : QObject(parent), widget(widget)
+{
+    generatorTimer.setInterval(generatorIntervalMs);
+    heartbeatTimer.setInterval(heartbeatIntervalMs);
+    connect(&generatorTimer, &QTimer::timeout, this, &TelemetryStressHarness::generate);
+    connect(&heartbeatTimer, &QTimer::timeout, this, &TelemetryStressHarness::heartbeat);
+}
+
+void TelemetryStressHarness::start(const StressConfig &config) {
+    if (generatorTimer.isActive())
+        return;
+
+    this->config = config;
+    generated = 0;
+    sendNs = 0;
+    channel = 0;
+    maxLagMs = 0.0;
+    totalLagMs = 0.0;
+    heartbeats = 0;
+
+    TelemetryThrottle *throttle = widget->telemetryInput();
+    previousPolicy = throttle->policy();
+    throttle->setPolicy(config.policy);
+    throttle->resetStats();
+
+    runClock.start();
+    heartbeatClock.start();
+    generatorTimer.start();
+    heartbeatTimer.start();
+}
+
+void TelemetryStressHarness::generate() {
+    const qint64 elapsedMs = runClock.elapsed();
+    if (elapsedMs >= config.durationMs) {
+        finish();
+        return;
+    }
+
+    qint64 due = 0;
+    switch (config.pattern) {
+    case StressPattern::CONSTANT:
+        due = static_cast<qint64>(config.ratePerSecond) * elapsedMs / 1000;
+        break;
+    case StressPattern::BURST: {
+        const qint64 burstPeriodMs = std::max<qint64>(1, 1000LL * config.burstSize / std::max(1, config.ratePerSecond));
+        due = (elapsedMs / burstPeriodMs + 1) * config.burstSize;
+        break;
+    }
+    case StressPattern::RAMP:
+        due = static_cast<qint64>(config.ratePerSecond) * elapsedMs * elapsedMs / (1000LL * config.durationMs);
+        break;
+    }
+
+    QElapsedTimer sendClock;
+    sendClock.start();
+    for (; generated < due; ++generated)
+        emitSample();
+    sendNs += sendClock.nsecsElapsed();
+}
+
+void TelemetryStressHarness::heartbeat() {
+    const double lagMs = std::max<qint64>(0, heartbeatClock.elapsed() - heartbeatIntervalMs);
+    heartbeatClock.restart();
+    maxLagMs = std::max(maxLagMs, lagMs);
+    totalLagMs += lagMs;
+    ++heartbeats;
+}
+
+void TelemetryStressHarness::emitSample() {
+    const TelemetryChannel target = static_cast<TelemetryChannel>(channel);
+    channel = (channel + 1) % static_cast<int>(TelemetryChannel::CHANNEL_COUNT);
+
+    double value = 0.0;
+    switch (target) {
+    case TelemetryChannel::TEMPERATURE:
+        value = 16.0 + (std::rand() % 140) * 0.1;
+        break;
+    case TelemetryChannel::HUMIDITY:
+        value = 40.0 + (std::rand() % 20);
+        break;
+    case TelemetryChannel::PRESSURE:
+        value = 100000 + (std::rand() % 5000);
+        break;
+    case TelemetryChannel::AIRFLOW:
+        value = std::rand() % 4;
+        break;
+    default:
+        value = (std::rand() % 10 == 0) ? static_cast<int>(BlockStatus::BLOCK_ERROR) : static_cast<int>(BlockStatus::BLOCK_ON);
+        break;
+    }
+
+    if (config.target == StressTarget::BACKEND_BOUNDARY) {
+        widget->telemetryInput()->submit(target, value);
+        return;
+    }
+
+    switch (target) {
+    case TelemetryChannel::TEMPERATURE:
+        widget->updateTemperature(value);
+        break;
+    case TelemetryChannel::HUMIDITY:
+        widget->updateHumidity(value);
+        break;
+    case TelemetryChannel::PRESSURE:
+        widget->updatePressure(value);
+        break;
+    case TelemetryChannel::AIRFLOW:
+        widget->updateAirflowDirection(static_cast<AirFlowDirection>(static_cast<int>(value)));
+        break;
+    case TelemetryChannel::BLOCK1_STATUS:
+        widget->setBlock1Status(static_cast<BlockStatus>(static_cast<int>(value)));
+        break;
+    case TelemetryChannel::BLOCK2_STATUS:
+        widget->setBlock2Status(static_cast<BlockStatus>(static_cast<int>(value)));
+        break;
+    case TelemetryChannel::BLOCK3_STATUS:
+        widget->setBlock3Status(static_cast<BlockStatus>(static_cast<int>(value)));
+        break;
+    case TelemetryChannel::CHANNEL_COUNT:
+        break;
+    }
+}
+
+void TelemetryStressHarness::finish() {
+    generatorTimer.stop();
+    heartbeatTimer.stop();
+
+    TelemetryThrottle *throttle = widget->telemetryInput();
+    throttle->flush();
+    const TelemetryStats &stats = throttle->stats();
+
+    const double seconds = runClock.elapsed() / 1000.0;
+    const double avgLagMs = heartbeats > 0 ? totalLagMs / heartbeats : 0.0;
+    const double avgLatencyMs = stats.flushes > 0 ? stats.totalLatencyMs / stats.flushes : 0.0;
+
+    QString report = QString(
+        "samples: %1 (%2/s), delivery time: %3 ms\n"
+        "received: %4, applied: %5, dropped: %6, aggregated: %7\n"
+        "max queue depth: %8\n"
+        "latency avg: %9 ms, max: %10 ms\n"
+        "event loop lag avg: %11 ms, max: %12 ms")
+        .arg(generated).arg(seconds > 0 ? generated / seconds : 0.0, 0, 'f', 0).arg(sendNs / 1e6, 0, 'f', 1)
+        .arg(stats.received).arg(stats.applied).arg(stats.dropped).arg(stats.aggregated)
+        .arg(stats.maxQueueDepth)
+        .arg(avgLatencyMs, 0, 'f', 2).arg(stats.maxLatencyMs, 0, 'f', 2)
+        .arg(avgLagMs, 0, 'f', 2).arg(maxLagMs, 0, 'f', 2);
+
+    throttle->setPolicy(previousPolicy);
+    emit finished(report);
+}
@@ -0,0 +1,114 @@
+#ifndef TELEMETRYSTRESSHARNESS_H
+#define TELEMETRYSTRESSHARNESS_H
+
+/**
+ * @file telemetrystressharness.h
+ * @brief Generates telemetry bursts against ControllerWidget and reports how it copes.
+ */
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "telemetrythrottle.h"
+
+/**
+ * @enum StressPattern
+ * @brief Shape of the generated load.
+ */
+enum class StressPattern {
+    CONSTANT,  ///< Samples spread evenly at the configured rate
+    BURST,     ///< Groups of samples delivered at once, then silence
+    RAMP       ///< Rate rising linearly from zero to twice the configured rate
+};
+
+/**
+ * @enum StressTarget
+ * @brief Where the generated samples enter the application.
+ */
+enum class StressTarget {
+    WIDGET_SLOTS,     ///< Straight into the ControllerWidget slots, as the backend does without a throttle
+    BACKEND_BOUNDARY  ///< Through the widget's TelemetryThrottle
+};
+
+/**
+ * @struct StressConfig
+ * @brief Parameters of a stress run.
+ */
+struct StressConfig {
+    StressPattern pattern = StressPattern::BURST;      ///< Shape of the load.
+    StressTarget target = StressTarget::BACKEND_BOUNDARY; ///< Entry point of the samples.
+    SheddingPolicy policy = SheddingPolicy::KEEP_LATEST;  ///< Policy used at the backend boundary.
+    int ratePerSecond = 100000;  ///< Average number of samples per second.
+    int burstSize = 5000;        ///< Samples per burst for StressPattern::BURST.
+    int durationMs = 10000;      ///< Length of the run.
+};
+
+/**
+ * @class TelemetryStressHarness
+ * @brief Drives a configurable stream of samples into ControllerWidget.
+ *
+ * Responsiveness is measured with a heartbeat timer: the delay between its
+ * expected and actual firing is how long the event loop was blocked.
+ */
+class TelemetryStressHarness : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor.
+     * @param widget The widget under test.
+     * @param parent Optional parent.
+     */
+    explicit TelemetryStressHarness(ControllerWidget *widget, QObject *parent = nullptr);
+
+    /**
+     * @brief Starts a run. Does nothing if a run is already active.
+     * @param config Parameters of the run.
+     */
+    void start(const StressConfig &config);
+
+signals:
+    /**
+     * @brief Emitted when a run ends.
+     * @param report Human readable summary of the run.
+     */
+    void finished(const QString &report);
+
+private slots:
+    /**
+     * @brief Generates the samples due since the previous tick.
+     */
+    void generate();
+
+    /**
+     * @brief Records how late the event loop delivered the heartbeat.
+     */
+    void heartbeat();
+
+private:
+    /**
+     * @brief Delivers one random sample to the configured target.
+     */
+    void emitSample();
+
+    /**
+     * @brief Stops the run and emits finished().
+     */
+    void finish();
+
+    ControllerWidget *widget;     ///< The widget under test.
+    StressConfig config;          ///< Parameters of the current run.
+    QTimer generatorTimer;        ///< Timer driving sample generation.
+    QTimer heartbeatTimer;        ///< Timer measuring event loop delay.
+    QElapsedTimer runClock;       ///< Time since the run started.
+    QElapsedTimer heartbeatClock; ///< Time since the previous heartbeat.
+    qint64 generated = 0;         ///< Samples delivered so far.
+    qint64 sendNs = 0;            ///< Time spent delivering samples.
+    int channel = 0;              ///< Channel of the next sample.
+    double maxLagMs = 0.0;        ///< Largest heartbeat delay.
+    double totalLagMs = 0.0;      ///< Sum of heartbeat delays.
+    int heartbeats = 0;           ///< Number of heartbeats received.
+    SheddingPolicy previousPolicy = SheddingPolicy::KEEP_LATEST; ///< Policy restored after the run.
+};
+
+#endif // TELEMETRYSTRESSHARNESS_H
@@ -0,0 +1,147 @@
+#include "telemetrythrottle.h"
+
+#include <algorithm>
+
+namespace {
+
+bool isNumericChannel(TelemetryChannel channel) {
+    return channel == TelemetryChannel::TEMPERATURE
+           || channel == TelemetryChannel::HUMIDITY
+           || channel == TelemetryChannel::PRESSURE;
+}
+
+bool isStatusChannel(TelemetryChannel channel) {
+    return channel == TelemetryChannel::BLOCK1_STATUS
+           || channel == TelemetryChannel::BLOCK2_STATUS
+           || channel == TelemetryChannel::BLOCK3_STATUS;
+}
+
+}
+
+TelemetryThrottle::TelemetryThrottle(ControllerWidget *widget, QObject *parent)
+    : QObject(parent), widget(widget)
+{
+    clock.start();
+
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(16);
+    connect(&flushTimer, &QTimer::timeout, this, &TelemetryThrottle::flush);
+}
+
+SheddingPolicy TelemetryThrottle::policy() const {
+    return currentPolicy;
+}
+
+void TelemetryThrottle::setPolicy(SheddingPolicy policy) {
+    flush();
+    currentPolicy = policy;
+}
+
+const TelemetryStats &TelemetryThrottle::stats() const {
+    return counters;
+}
+
+void TelemetryThrottle::resetStats() {
+    const int depth = counters.queueDepth;
+    counters = TelemetryStats();
+    counters.queueDepth = depth;
+    counters.maxQueueDepth = depth;
+}
+
+void TelemetryThrottle::submit(TelemetryChannel channel, double value) {
+    ++counters.received;
+
+    if (currentPolicy == SheddingPolicy::PASSTHROUGH) {
+        apply(channel, value);
+        ++counters.applied;
+        return;
+    }
+
+    PendingValue &slot = pending[static_cast<int>(channel)];
+
+    if (!slot.pending) {
+        slot.pending = true;
+        slot.value = value;
+        slot.samples = 1;
+        slot.firstNs = clock.nsecsElapsed();
+
+        ++counters.queueDepth;
+        counters.maxQueueDepth = std::max(counters.maxQueueDepth, counters.queueDepth);
+        if (!flushTimer.isActive())
+            flushTimer.start();
+        return;
+    }
+
+    ++slot.samples;
+    if (currentPolicy == SheddingPolicy::AGGREGATE && isNumericChannel(channel)) {
+        slot.value += value;
+        ++counters.aggregated;
+    }
+    else if (currentPolicy == SheddingPolicy::AGGREGATE && isStatusChannel(channel)
+             && slot.value == static_cast<int>(BlockStatus::BLOCK_ERROR)) {
+        ++counters.dropped;
+    }
+    else {
+        slot.value = value;
+        ++counters.dropped;
+    }
+}
+
+void TelemetryThrottle::flush() {
+    flushTimer.stop();
+    if (counters.queueDepth == 0)
+        return;
+
+    const qint64 now = clock.nsecsElapsed();
+    qint64 oldest = now;
+
+    for (int i = 0; i < static_cast<int>(pending.size()); ++i) {
+        PendingValue &slot = pending[i];
+        if (!slot.pending)
+            continue;
+
+        TelemetryChannel channel = static_cast<TelemetryChannel>(i);
+        double value = slot.value;
+        if (currentPolicy == SheddingPolicy::AGGREGATE && isNumericChannel(channel))
+            value /= slot.samples;
+
+        oldest = std::min(oldest, slot.firstNs);
+        slot.pending = false;
+        apply(channel, value);
+        ++counters.applied;
+    }
+
+    counters.queueDepth = 0;
+    counters.lastLatencyMs = (now - oldest) / 1e6;
+    counters.maxLatencyMs = std::max(counters.maxLatencyMs, counters.lastLatencyMs);
+    counters.totalLatencyMs += counters.lastLatencyMs;
+    ++counters.flushes;
+}
+
+void TelemetryThrottle::apply(TelemetryChannel channel, double value) {
+    switch (channel) {
+    case TelemetryChannel::TEMPERATURE:
+        widget->updateTemperature(value);
+        break;
+    case TelemetryChannel::HUMIDITY:
+        widget->updateHumidity(value);
+        break;
+    case TelemetryChannel::PRESSURE:
+        widget->updatePressure(value);
+        break;
+    case TelemetryChannel::AIRFLOW:
+        widget->updateAirflowDirection(static_cast<AirFlowDirection>(static_cast<int>(value)));
+        break;
+    case TelemetryChannel::BLOCK1_STATUS:
+        widget->setBlock1Status(static_cast<BlockStatus>(static_cast<int>(value)));
+        break;
+    case TelemetryChannel::BLOCK2_STATUS:
+        widget->setBlock2Status(static_cast<BlockStatus>(static_cast<int>(value)));
+        break;
+    case TelemetryChannel::BLOCK3_STATUS:
+        widget->setBlock3Status(static_cast<BlockStatus>(static_cast<int>(value)));
+        break;
+    case TelemetryChannel::CHANNEL_COUNT:
+        break;
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef TELEMETRYTHROTTLE_H
+#define TELEMETRYTHROTTLE_H
+
+/**
+ * @file telemetrythrottle.h
+ * @brief Defines the load-shedding buffer between a backend and ControllerWidget.
+ */
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <array>
+#include "controllerwidget.h"
+
+/**
+ * @enum TelemetryChannel
+ * @brief Identifies a stream of values delivered to ControllerWidget.
+ */
+enum class TelemetryChannel {
+    TEMPERATURE,    ///< Current temperature in Celsius
+    HUMIDITY,       ///< Current humidity percentage
+    PRESSURE,       ///< Current pressure in Pascals
+    AIRFLOW,        ///< Current airflow direction
+    BLOCK1_STATUS,  ///< Status of block 1
+    BLOCK2_STATUS,  ///< Status of block 2
+    BLOCK3_STATUS,  ///< Status of block 3
+    CHANNEL_COUNT   ///< Number of channels
+};
+
+/**
+ * @enum SheddingPolicy
+ * @brief Determines what happens to samples arriving faster than the GUI renders.
+ */
+enum class SheddingPolicy {
+    PASSTHROUGH,  ///< Every sample is applied immediately
+    KEEP_LATEST,  ///< Only the newest sample per channel is applied once per frame
+    AGGREGATE     ///< Numeric samples are averaged per frame, block errors are kept
+};
+
+/**
+ * @struct TelemetryStats
+ * @brief Counters describing the load on a TelemetryThrottle.
+ */
+struct TelemetryStats {
+    quint64 received = 0;        ///< Samples submitted.
+    quint64 applied = 0;         ///< Values delivered to the widget.
+    quint64 dropped = 0;         ///< Samples discarded in favour of another one.
+    quint64 aggregated = 0;      ///< Samples merged into an average.
+    int queueDepth = 0;          ///< Channels with a value waiting for the next frame.
+    int maxQueueDepth = 0;       ///< Largest queue depth observed.
+    double lastLatencyMs = 0.0;  ///< Age of the oldest sample at the last flush.
+    double maxLatencyMs = 0.0;   ///< Largest latency observed.
+    double totalLatencyMs = 0.0; ///< Sum of flush latencies, for averaging.
+    quint64 flushes = 0;         ///< Number of frames in which values were applied.
+};
+
+/**
+ * @class TelemetryThrottle
+ * @brief Buffers backend updates and applies them to ControllerWidget at most once per frame.
+ *
+ * Each channel has a single pending slot, so memory use and queue length are
+ * bounded by the number of channels no matter how fast samples arrive.
+ */
+class TelemetryThrottle : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor.
+     * @param widget The widget receiving the values.
+     * @param parent Optional parent.
+     */
+    explicit TelemetryThrottle(ControllerWidget *widget, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the current shedding policy.
+     */
+    SheddingPolicy policy() const;
+
+    /**
+     * @brief Changes the shedding policy. Pending samples are applied first.
+     * @param policy New policy.
+     */
+    void setPolicy(SheddingPolicy policy);
+
+    /**
+     * @brief Returns the current counters.
+     */
+    const TelemetryStats &stats() const;
+
+    /**
+     * @brief Resets all counters.
+     */
+    void resetStats();
+
+public slots:
+    /**
+     * @brief Submits a sample.
+     * @param channel Channel of the sample.
+     * @param value Numeric value, or the enum index for airflow and status channels.
+     */
+    void submit(TelemetryChannel channel, double value);
+
+    /**
+     * @brief Applies every pending value to the widget.
+     */
+    void flush();
+
+private:
+    /**
+     * @struct PendingValue
+     * @brief Value waiting to be applied for one channel.
+     */
+    struct PendingValue {
+        bool pending = false;  ///< Whether the channel has a value to apply.
+        double value = 0.0;    ///< Newest value, or running sum when aggregating.
+        int samples = 0;       ///< Number of samples merged into this value.
+        qint64 firstNs = 0;    ///< Arrival time of the oldest merged sample.
+    };
+
+    /**
+     * @brief Delivers a value to the matching widget slot.
+     * @param channel Target channel.
+     * @param value Value to deliver.
+     */
+    void apply(TelemetryChannel channel, double value);
+
+    ControllerWidget *widget;   ///< The widget receiving the values.
+    SheddingPolicy currentPolicy = SheddingPolicy::KEEP_LATEST; ///< Active policy.
+    std::array<PendingValue, static_cast<int>(TelemetryChannel::CHANNEL_COUNT)> pending; ///< One slot per channel.
+    TelemetryStats counters;    ///< Load counters.
+    QElapsedTimer clock;        ///< Monotonic clock for latency measurement.
+    QTimer flushTimer;          ///< Single-shot timer coalescing samples into one flush per frame.
+};
+
+#endif // TELEMETRYTHROTTLE_H
@@ -0,0 +1,78 @@
+#include "themebenchmark.h"
+#include "themeengine.h"
+
+#include <QApplication>
+#include <QScrollArea>
+#include <QGridLayout>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+const int rounds = 5;
+
+void report(const QString &name, const std::function<void(bool)> &switchTheme) {
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+
+    for (int round = 0; round < rounds * 2; ++round) {
+        QElapsedTimer timer;
+        timer.start();
+        switchTheme(round % 2 == 0);
+        QApplication::processEvents();
+        const double ms = timer.nsecsElapsed() / 1e6;
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+    }
+
+    qInfo().noquote() << QString("%1: avg %2 ms, max %3 ms per switch")
+                             .arg(name).arg(totalMs / (rounds * 2), 0, 'f', 1).arg(maxMs, 0, 'f', 1);
+}
+
+}
+
+int runThemeBenchmark(int units) {
+    ThemeEngine engine;
+
+    QWidget root;
+    root.resize(1024, 768);
+    QVBoxLayout *layout = new QVBoxLayout(&root);
+
+    QGraphicsScene *scene = new QGraphicsScene(&root);
+    QGraphicsView *view = new QGraphicsView(scene, &root);
+    layout->addWidget(view);
+
+    const int columns = 100;
+    for (int i = 0; i < units; ++i) {
+        const BlockStatus status = static_cast<BlockStatus>(i % 3);
+        QGraphicsRectItem *block = scene->addRect((i % columns) * 50, (i / columns) * 50, 40, 40);
+        block->setData(ThemeEngine::STATUS_KEY, static_cast<int>(status));
+        block->setBrush(engine.blockBrush(status));
+        QGraphicsTextItem *label = scene->addText(QString::number(i + 1));
+        label->setPos((i % columns) * 50, (i / columns) * 50);
+    }
+
+    QScrollArea *scroll = new QScrollArea(&root);
+    QWidget *panel = new QWidget();
+    QGridLayout *grid = new QGridLayout(panel);
+    for (int i = 0; i < units; ++i)
+        grid->addWidget(new QLabel(QString("Блок %1").arg(i + 1), panel), i / 10, i % 10);
+    scroll->setWidget(panel);
+    layout->addWidget(scroll);
+
+    root.show();
+    QApplication::processEvents();
+
+    qInfo().noquote() << QString("%1 units, %2 widgets").arg(units).arg(root.findChildren<QWidget *>().size() + 1);
+
+    report("style sheet", [&](bool dark) {
+        root.setStyleSheet(dark ? "background: #333; color: white;" : "");
+    });
+    report("palette", [&](bool dark) {
+        engine.apply(dark ? Theme::DARK : Theme::LIGHT, &root, scene);
+    });
+
+    return 0;
+}
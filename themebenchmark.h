@@ -0,0 +1,20 @@
+#ifndef THEMEBENCHMARK_H
+#define THEMEBENCHMARK_H
+
+/**
+ * @file themebenchmark.h
+ * @brief Measures the cost of switching themes on a large dashboard.
+ */
+
+/**
+ * @brief Compares a style sheet theme switch with a ThemeEngine switch and prints the timings.
+ *
+ * Builds a window with the given number of scene blocks and status labels,
+ * then times both approaches including the repaint that follows.
+ *
+ * @param units Number of units to create.
+ * @return Process exit code.
+ */
+int runThemeBenchmark(int units);
+
+#endif // THEMEBENCHMARK_H
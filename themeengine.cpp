@@ -0,0 +1,99 @@
+#include "themeengine.h"
+
+#include <QApplication>
+#include <QStyle>
+#include <QWidget>
+#include <QGraphicsItem>
+
+namespace {
+
+int themeIndex(Theme theme) {
+    return static_cast<bool>(theme) ? 1 : 0;
+}
+
+QPalette darkPalette() {
+    const QColor window(0x33, 0x33, 0x33);
+    const QColor base(0x2b, 0x2b, 0x2b);
+    const QColor button(0x3c, 0x3c, 0x3c);
+    const QColor disabledText(0x80, 0x80, 0x80);
+
+    QPalette palette;
+    palette.setColor(QPalette::Window, window);
+    palette.setColor(QPalette::WindowText, Qt::white);
+    palette.setColor(QPalette::Base, base);
+    palette.setColor(QPalette::AlternateBase, window);
+    palette.setColor(QPalette::ToolTipBase, base);
+    palette.setColor(QPalette::ToolTipText, Qt::white);
+    palette.setColor(QPalette::PlaceholderText, disabledText);
+    palette.setColor(QPalette::Text, Qt::white);
+    palette.setColor(QPalette::Button, button);
+    palette.setColor(QPalette::ButtonText, Qt::white);
+    palette.setColor(QPalette::BrightText, Qt::red);
+    palette.setColor(QPalette::Light, QColor(0x4a, 0x4a, 0x4a));
+    palette.setColor(QPalette::Midlight, QColor(0x42, 0x42, 0x42));
+    palette.setColor(QPalette::Mid, QColor(0x2a, 0x2a, 0x2a));
+    palette.setColor(QPalette::Dark, QColor(0x22, 0x22, 0x22));
+    palette.setColor(QPalette::Shadow, Qt::black);
+    palette.setColor(QPalette::Highlight, QColor(0x2a, 0x82, 0xda));
+    palette.setColor(QPalette::HighlightedText, Qt::white);
+    palette.setColor(QPalette::Link, QColor(0x2a, 0x82, 0xda));
+
+    palette.setColor(QPalette::Disabled, QPalette::WindowText, disabledText);
+    palette.setColor(QPalette::Disabled, QPalette::Text, disabledText);
+    palette.setColor(QPalette::Disabled, QPalette::ButtonText, disabledText);
+    palette.setColor(QPalette::Disabled, QPalette::Highlight, QColor(0x50, 0x50, 0x50));
+    return palette;
+}
+
+}
+
+ThemeEngine::ThemeEngine(QObject *parent) : QObject(parent) {
+    ThemeStyle &light = styles[themeIndex(Theme::LIGHT)];
+    light.palette = QApplication::style()->standardPalette();
+    light.blockBrushes = {QBrush(Qt::gray), QBrush(Qt::red), QBrush(Qt::green)};
+    light.sceneTextColor = Qt::black;
+
+    ThemeStyle &dark = styles[themeIndex(Theme::DARK)];
+    dark.palette = darkPalette();
+    dark.blockBrushes = {QBrush(QColor(0x5a, 0x5a, 0x5a)), QBrush(QColor(0xc6, 0x28, 0x28)), QBrush(QColor(0x2e, 0x9d, 0x3a))};
+    dark.sceneTextColor = Qt::white;
+}
+
+Theme ThemeEngine::theme() const {
+    return current;
+}
+
+void ThemeEngine::apply(Theme theme, QWidget *root, QGraphicsScene *scene) {
+    current = theme;
+    root->setPalette(style(theme).palette);
+    if (scene != nullptr)
+        applyToScene(scene);
+}
+
+void ThemeEngine::applyToScene(QGraphicsScene *scene) const {
+    const ThemeStyle &active = style(current);
+
+    const QList<QGraphicsItem *> items = scene->items();
+    for (QGraphicsItem *item : items) {
+        if (QGraphicsRectItem *rect = qgraphicsitem_cast<QGraphicsRectItem *>(item)) {
+            const QVariant status = rect->data(STATUS_KEY);
+            if (status.isValid())
+                rect->setBrush(active.blockBrushes[status.toInt()]);
+        }
+        else if (QGraphicsTextItem *text = qgraphicsitem_cast<QGraphicsTextItem *>(item)) {
+            text->setDefaultTextColor(active.sceneTextColor);
+        }
+    }
+}
+
+const QBrush &ThemeEngine::blockBrush(BlockStatus status) const {
+    return style(current).blockBrushes[static_cast<int>(status)];
+}
+
+const QPalette &ThemeEngine::palette(Theme theme) const {
+    return style(theme).palette;
+}
+
+const ThemeEngine::ThemeStyle &ThemeEngine::style(Theme theme) const {
+    return styles[themeIndex(theme)];
+}
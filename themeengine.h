@@ -0,0 +1,95 @@
+#ifndef THEMEENGINE_H
+#define THEMEENGINE_H
+
+/**
+ * @file themeengine.h
+ * @brief Defines precomputed palettes and brushes for the dark and light themes.
+ */
+
+#include <QObject>
+#include <QPalette>
+#include <QBrush>
+#include <QColor>
+#include <array>
+#include "controllerwidget.h"
+
+/**
+ * @class ThemeEngine
+ * @brief Switches the application theme without style sheets.
+ *
+ * Both themes are built once up front. Switching only installs a ready
+ * QPalette on a widget tree, which its widgets pick up through a palette
+ * change event instead of re-parsing a style sheet and repolishing, and swaps
+ * the shared brushes used by the graphics scene. The palettes are meant for
+ * the Fusion style, which draws every control from the palette; main()
+ * selects it. Windows opened from the tree follow the theme if they have
+ * Qt::WA_WindowPropagation set.
+ */
+class ThemeEngine : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Item data key under which scene blocks store their BlockStatus.
+     */
+    static constexpr int STATUS_KEY = 0;
+
+    /**
+     * @brief Constructor. Builds the palettes of both themes.
+     * @param parent Optional parent.
+     */
+    explicit ThemeEngine(QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the active theme.
+     */
+    Theme theme() const;
+
+    /**
+     * @brief Activates a theme for a widget tree and recolors a scene.
+     * @param theme Theme to activate.
+     * @param root Widget whose palette is replaced; its children inherit it.
+     * @param scene Scene to recolor, may be nullptr.
+     */
+    void apply(Theme theme, QWidget *root, QGraphicsScene *scene);
+
+    /**
+     * @brief Recolors the blocks and labels of a scene with the active theme.
+     * @param scene Scene to recolor.
+     */
+    void applyToScene(QGraphicsScene *scene) const;
+
+    /**
+     * @brief Returns the shared brush for a block status in the active theme.
+     * @param status Block status.
+     */
+    const QBrush &blockBrush(BlockStatus status) const;
+
+    /**
+     * @brief Returns the palette of a theme.
+     * @param theme Theme.
+     */
+    const QPalette &palette(Theme theme) const;
+
+private:
+    /**
+     * @struct ThemeStyle
+     * @brief Everything needed to draw one theme.
+     */
+    struct ThemeStyle {
+        QPalette palette;                   ///< Widget palette.
+        std::array<QBrush, 3> blockBrushes; ///< Block brushes indexed by BlockStatus.
+        QColor sceneTextColor;              ///< Color of scene labels.
+    };
+
+    /**
+     * @brief Returns the style of a theme.
+     * @param theme Theme.
+     */
+    const ThemeStyle &style(Theme theme) const;
+
+    std::array<ThemeStyle, 2> styles;  ///< Styles indexed by the Theme value.
+    Theme current = Theme::LIGHT;      ///< Active theme.
+};
+
+#endif // THEMEENGINE_H
@@ -0,0 +1,74 @@
+#include "timerwheel.h"
+
+TimerWheel::TimerWheel(quint64 startTick) : tick(startTick) {
+}
+
+void TimerWheel::reset(quint64 startTick) {
+    tick = startTick;
+}
+
+void TimerWheel::clear() {
+    for (auto &level : wheels)
+        for (std::vector<Timer> &slot : level)
+            slot.clear();
+    overflow.clear();
+    overdue.clear();
+    count = 0;
+}
+
+void TimerWheel::schedule(quint64 expiryTick, quint64 payload) {
+    ++count;
+    if (expiryTick <= tick)
+        overdue.push_back({expiryTick, payload});
+    else
+        place({expiryTick, payload});
+}
+
+void TimerWheel::place(const Timer &timer) {
+    for (int level = 0; level < LEVELS; ++level) {
+        const int shift = SLOT_BITS * (level + 1);
+        if ((timer.expiry >> shift) == (tick >> shift)) {
+            wheels[level][(timer.expiry >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back(timer);
+            return;
+        }
+    }
+    overflow.push_back(timer);
+}
+
+void TimerWheel::cascade(int level) {
+    std::vector<Timer> timers;
+    timers.swap(wheels[level][(tick >> (SLOT_BITS * level)) & (SLOTS - 1)]);
+    for (const Timer &timer : timers)
+        place(timer);
+}
+
+void TimerWheel::advance(quint64 toTick, std::vector<quint64> &fired) {
+    for (const Timer &timer : overdue)
+        fired.push_back(timer.payload);
+    count -= static_cast<qint64>(overdue.size());
+    overdue.clear();
+
+    while (tick < toTick) {
+        ++tick;
+
+        int top = 0;
+        while (top < LEVELS && (tick & ((quint64(1) << (SLOT_BITS * (top + 1))) - 1)) == 0)
+            ++top;
+
+        if (top == LEVELS) {
+            std::vector<Timer> timers;
+            timers.swap(overflow);
+            for (const Timer &timer : timers)
+                place(timer);
+            top = LEVELS - 1;
+        }
+        for (int level = top; level >= 1; --level)
+            cascade(level);
+
+        std::vector<Timer> &slot = wheels[0][tick & (SLOTS - 1)];
+        for (const Timer &timer : slot)
+            fired.push_back(timer.payload);
+        count -= static_cast<qint64>(slot.size());
+        slot.clear();
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+/**
+ * @file timerwheel.h
+ * @brief Defines a hierarchical timer wheel for large numbers of pending timers.
+ */
+
+#include <QtGlobal>
+#include <array>
+#include <vector>
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel keyed by integer ticks.
+ *
+ * Four levels of 64 slots cover 64^4 ticks (about 194 days at one tick per
+ * second); later timers wait in an overflow list. Scheduling is O(1), and
+ * advancing costs O(1) per tick plus the timers that fire or move down a
+ * level, independent of how many timers are pending.
+ */
+class TimerWheel {
+public:
+    /**
+     * @brief Constructor.
+     * @param startTick Tick the wheel starts at.
+     */
+    explicit TimerWheel(quint64 startTick = 0);
+
+    /**
+     * @brief Returns the tick the wheel has advanced to.
+     */
+    quint64 currentTick() const { return tick; }
+
+    /**
+     * @brief Moves the wheel to a tick without firing anything. Only valid while empty.
+     * @param startTick New current tick.
+     */
+    void reset(quint64 startTick);
+
+    /**
+     * @brief Removes every pending timer without firing it. The current tick is kept.
+     */
+    void clear();
+
+    /**
+     * @brief Schedules a timer.
+     * @param expiryTick Tick at which the timer fires. Past ticks fire on the next advance().
+     * @param payload Value returned when the timer fires.
+     */
+    void schedule(quint64 expiryTick, quint64 payload);
+
+    /**
+     * @brief Advances the wheel, collecting the payloads of all timers that expire.
+     * @param toTick Tick to advance to. Ticks not after the current one only flush overdue timers.
+     * @param fired Receives the payloads in expiry order.
+     */
+    void advance(quint64 toTick, std::vector<quint64> &fired);
+
+    /**
+     * @brief Returns the number of pending timers.
+     */
+    qint64 size() const { return count; }
+
+private:
+    static constexpr int LEVELS = 4;      ///< Number of wheel levels.
+    static constexpr int SLOT_BITS = 6;   ///< log2 of the slots per level.
+    static constexpr int SLOTS = 1 << SLOT_BITS; ///< Slots per level.
+
+    /**
+     * @struct Timer
+     * @brief A pending timer.
+     */
+    struct Timer {
+        quint64 expiry;  ///< Tick at which the timer fires.
+        quint64 payload; ///< Value returned when the timer fires.
+    };
+
+    /**
+     * @brief Places a timer in the slot matching its expiry.
+     * @param timer Timer to place.
+     */
+    void place(const Timer &timer);
+
+    /**
+     * @brief Redistributes the timers of the current slot of a level to lower levels.
+     * @param level Level to cascade.
+     */
+    void cascade(int level);
+
+    std::array<std::array<std::vector<Timer>, SLOTS>, LEVELS> wheels; ///< Slots of every level.
+    std::vector<Timer> overflow; ///< Timers beyond the range of the top level.
+    std::vector<Timer> overdue;  ///< Timers scheduled at or before the current tick.
+    quint64 tick;                ///< Current tick.
+    qint64 count = 0;            ///< Number of pending timers.
+};
+
+#endif // TIMERWHEEL_H
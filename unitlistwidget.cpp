@@ -0,0 +1,49 @@
+#include "unitlistwidget.h"
+
+#include <QHeaderView>
+
+UnitListWidget::UnitListWidget(UnitTableModel *model, QWidget *parent) : QWidget(parent) {
+    setWindowFlag(Qt::Window);
+    setWindowTitle("Список блоков");
+    resize(800, 600);
+
+    proxy = new UnitFilterProxyModel(this);
+    proxy->setSourceModel(model);
+
+    table = new QTableView(this);
+    table->setModel(proxy);
+    table->setSortingEnabled(true);
+    table->sortByColumn(UnitTableModel::NAME_COLUMN, Qt::AscendingOrder);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setWordWrap(false);
+    table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table->verticalHeader()->setDefaultSectionSize(table->fontMetrics().height() + 6);
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    nameFilterEdit = new QLineEdit(this);
+    nameFilterEdit->setPlaceholderText("Поиск по имени");
+
+    statusFilterCombo = new QComboBox(this);
+    statusFilterCombo->addItems({"Все", "Выключен", "Ошибка", "Включен"});
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    QHBoxLayout *filterLayout = new QHBoxLayout();
+
+    filterLayout->addWidget(nameFilterEdit);
+    filterLayout->addWidget(statusFilterCombo);
+
+    mainLayout->addLayout(filterLayout);
+    mainLayout->addWidget(table);
+
+    connect(nameFilterEdit, &QLineEdit::textChanged, this, &UnitListWidget::changeNameFilter);
+    connect(statusFilterCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &UnitListWidget::changeStatusFilter);
+}
+
+void UnitListWidget::changeNameFilter(const QString &text) {
+    proxy->setNameFilter(text);
+}
+
+void UnitListWidget::changeStatusFilter(int index) {
+    proxy->setStatusFilter(index - 1);
+}
@@ -0,0 +1,68 @@
+#ifndef UNITLISTWIDGET_H
+#define UNITLISTWIDGET_H
+
+/**
+ * @file unitlistwidget.h
+ * @brief Defines the window listing every unit in a sortable, filterable table.
+ */
+
+#include <QWidget>
+#include <QTableView>
+#include <QLineEdit>
+#include <QComboBox>
+#include "unittablemodel.h"
+
+/**
+ * @class UnitListWidget
+ * @brief A window showing the state of all units in a table.
+ *
+ * The table view only paints visible rows, and rows have a fixed height so the
+ * view never has to measure the whole model while scrolling.
+ */
+class UnitListWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor.
+     * @param model Model holding the state of all units.
+     * @param parent Parent QWidget.
+     */
+    explicit UnitListWidget(UnitTableModel *model, QWidget *parent = nullptr);
+
+private slots:
+    /**
+     * @brief Called when the name filter text changes.
+     * @param text New filter text.
+     */
+    void changeNameFilter(const QString &text);
+
+    /**
+     * @brief Called when the status filter combo box changes.
+     * @param index 0 = all, otherwise BlockStatus index + 1.
+     */
+    void changeStatusFilter(int index);
+
+private:
+    /**
+     * @brief Proxy used for sorting and filtering.
+     */
+    UnitFilterProxyModel *proxy;
+
+    /**
+     * @brief Table displaying the units.
+     */
+    QTableView *table;
+
+    /**
+     * @brief Input for the name filter.
+     */
+    QLineEdit *nameFilterEdit;
+
+    /**
+     * @brief Combo box for the status filter.
+     */
+    QComboBox *statusFilterCombo;
+};
+
+#endif // UNITLISTWIDGET_H
@@ -0,0 +1,189 @@
+#include "unittablemodel.h"
+
+#include <algorithm>
+
+UnitTableModel::UnitTableModel(QObject *parent) : QAbstractTableModel(parent) {
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(16);
+    connect(&flushTimer, &QTimer::timeout, this, &UnitTableModel::flushChanges);
+}
+
+int UnitTableModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(units.size());
+}
+
+int UnitTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant UnitTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= units.size())
+        return QVariant();
+
+    const UnitState &state = units[index.row()];
+
+    if (role == Qt::TextAlignmentRole && index.column() != NAME_COLUMN)
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+
+    if (role != Qt::DisplayRole && role != SortRole)
+        return QVariant();
+
+    switch (index.column()) {
+    case NAME_COLUMN:
+        // Names are numbered in row order, so the row sorts them numerically.
+        return role == SortRole ? QVariant(index.row()) : QVariant(state.name);
+    case TEMPERATURE_COLUMN:
+        return role == SortRole ? QVariant(state.temperatureC) : QVariant(QString::number(state.temperatureC, 'f', 1));
+    case HUMIDITY_COLUMN:
+        return role == SortRole ? QVariant(state.humidity) : QVariant(QString::number(state.humidity, 'f', 0));
+    case PRESSURE_COLUMN:
+        return role == SortRole ? QVariant(state.pressurePa) : QVariant(QString::number(state.pressurePa, 'f', 0));
+    case AIRFLOW_COLUMN:
+        if (role == SortRole) return static_cast<int>(state.airflow);
+        switch (state.airflow) {
+        case AirFlowDirection::AUTO: return QString("Авто");
+        case AirFlowDirection::UP: return QString("Вверх");
+        case AirFlowDirection::DOWN: return QString("Вниз");
+        case AirFlowDirection::SIDEWAYS: return QString("В стороны");
+        }
+        break;
+    case STATUS_COLUMN:
+        if (role == SortRole) return static_cast<int>(state.status);
+        switch (state.status) {
+        case BlockStatus::BLOCK_OFF: return QString("Выключен");
+        case BlockStatus::BLOCK_ERROR: return QString("Ошибка");
+        case BlockStatus::BLOCK_ON: return QString("Включен");
+        }
+        break;
+    }
+    return QVariant();
+}
+
+QVariant UnitTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole)
+        return QVariant();
+    if (orientation == Qt::Vertical)
+        return section + 1;
+
+    switch (section) {
+    case NAME_COLUMN: return QString("Блок");
+    case TEMPERATURE_COLUMN: return QString("Температура (°C)");
+    case HUMIDITY_COLUMN: return QString("Влажность (%)");
+    case PRESSURE_COLUMN: return QString("Давление (Па)");
+    case AIRFLOW_COLUMN: return QString("Направление");
+    case STATUS_COLUMN: return QString("Состояние");
+    }
+    return QVariant();
+}
+
+void UnitTableModel::resize(int count) {
+    count = std::max(count, 0);
+    const int current = static_cast<int>(units.size());
+
+    if (count > current) {
+        beginInsertRows(QModelIndex(), current, count - 1);
+        units.resize(count);
+        dirtyFlags.resize(count);
+        for (int row = current; row < count; ++row)
+            units[row].name = QString("Блок %1").arg(row + 1);
+        endInsertRows();
+    }
+    else if (count < current) {
+        beginRemoveRows(QModelIndex(), count, current - 1);
+        units.resize(count);
+        dirtyFlags.resize(count);
+        dirtyRows.erase(std::remove_if(dirtyRows.begin(), dirtyRows.end(),
+                                       [count](int row) { return row >= count; }),
+                        dirtyRows.end());
+        endRemoveRows();
+    }
+}
+
+int UnitTableModel::unitCount() const {
+    return static_cast<int>(units.size());
+}
+
+const UnitState &UnitTableModel::unit(int row) const {
+    return units[row];
+}
+
+void UnitTableModel::setUnit(int row, const UnitState &state) {
+    if (row < 0 || row >= units.size())
+        return;
+
+    UnitState &current = units[row];
+    if (current.name == state.name
+        && current.temperatureC == state.temperatureC
+        && current.setpointC == state.setpointC
+        && current.humidity == state.humidity
+        && current.pressurePa == state.pressurePa
+        && current.airflow == state.airflow
+        && current.status == state.status)
+        return;
+
+    current = state;
+    markDirty(row);
+}
+
+void UnitTableModel::markDirty(int row) {
+    if (dirtyFlags[row])
+        return;
+
+    dirtyFlags[row] = true;
+    dirtyRows.append(row);
+    if (!flushTimer.isActive())
+        flushTimer.start();
+}
+
+void UnitTableModel::flushChanges() {
+    if (dirtyRows.isEmpty())
+        return;
+
+    std::sort(dirtyRows.begin(), dirtyRows.end());
+
+    int first = dirtyRows.front();
+    int last = first;
+    for (int i = 1; i <= dirtyRows.size(); ++i) {
+        if (i < dirtyRows.size() && dirtyRows[i] == last + 1) {
+            last = dirtyRows[i];
+            continue;
+        }
+        emit dataChanged(index(first, 0), index(last, COLUMN_COUNT - 1), {Qt::DisplayRole, SortRole});
+        if (i < dirtyRows.size())
+            first = last = dirtyRows[i];
+    }
+
+    for (int row : dirtyRows)
+        dirtyFlags[row] = false;
+    dirtyRows.clear();
+}
+
+UnitFilterProxyModel::UnitFilterProxyModel(QObject *parent) : QSortFilterProxyModel(parent) {
+    setSortRole(UnitTableModel::SortRole);
+    setDynamicSortFilter(true);
+}
+
+void UnitFilterProxyModel::setNameFilter(const QString &text) {
+    if (nameFilter == text)
+        return;
+    nameFilter = text;
+    invalidateFilter();
+}
+
+void UnitFilterProxyModel::setStatusFilter(int status) {
+    if (statusFilter == status)
+        return;
+    statusFilter = status;
+    invalidateFilter();
+}
+
+bool UnitFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    Q_UNUSED(sourceParent);
+
+    const UnitTableModel *units = static_cast<const UnitTableModel *>(sourceModel());
+    const UnitState &state = units->unit(sourceRow);
+
+    if (statusFilter >= 0 && static_cast<int>(state.status) != statusFilter)
+        return false;
+    return nameFilter.isEmpty() || state.name.contains(nameFilter, Qt::CaseInsensitive);
+}
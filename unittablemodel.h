@@ -0,0 +1,151 @@
+#ifndef UNITTABLEMODEL_H
+#define UNITTABLEMODEL_H
+
+/**
+ * @file unittablemodel.h
+ * @brief Defines the item model that exposes the state of every unit to table views.
+ */
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QTimer>
+#include <QVector>
+#include "controllerwidget.h"
+
+/**
+ * @struct UnitState
+ * @brief Snapshot of the readings and status of a single unit.
+ */
+struct UnitState {
+    QString name;                                       ///< Display name of the unit.
+    double temperatureC = 0.0;                          ///< Current temperature in Celsius.
+    double setpointC = 22.0;                            ///< Desired temperature in Celsius.
+    double humidity = 0.0;                              ///< Current relative humidity percentage.
+    double pressurePa = 0.0;                            ///< Current atmospheric pressure in Pascals.
+    AirFlowDirection airflow = AirFlowDirection::AUTO;  ///< Current airflow direction.
+    BlockStatus status = BlockStatus::BLOCK_OFF;        ///< Current block status.
+};
+
+/**
+ * @class UnitTableModel
+ * @brief Table model holding the shared state of all units.
+ *
+ * Updates are not announced one by one: changed rows are collected and
+ * emitted once per frame as contiguous dataChanged() ranges, so views only
+ * repaint the visible part of the table no matter how many units change.
+ */
+class UnitTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @enum Column
+     * @brief Columns exposed by the model.
+     */
+    enum Column {
+        NAME_COLUMN,         ///< Unit name
+        TEMPERATURE_COLUMN,  ///< Temperature in Celsius
+        HUMIDITY_COLUMN,     ///< Humidity percentage
+        PRESSURE_COLUMN,     ///< Pressure in Pascals
+        AIRFLOW_COLUMN,      ///< Airflow direction
+        STATUS_COLUMN,       ///< Block status
+        COLUMN_COUNT         ///< Number of columns
+    };
+
+    /**
+     * @brief Role returning raw numeric values used for sorting.
+     */
+    static constexpr int SortRole = Qt::UserRole;
+
+    /**
+     * @brief Constructor.
+     * @param parent Optional parent.
+     */
+    explicit UnitTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * @brief Changes the number of units, inserting or removing rows at the end.
+     * @param count New number of units.
+     */
+    void resize(int count);
+
+    /**
+     * @brief Returns the number of units.
+     */
+    int unitCount() const;
+
+    /**
+     * @brief Returns the state of a unit.
+     * @param row Unit index.
+     */
+    const UnitState &unit(int row) const;
+
+    /**
+     * @brief Replaces the state of a unit. The change is announced on the next frame.
+     * @param row Unit index.
+     * @param state New state.
+     */
+    void setUnit(int row, const UnitState &state);
+
+private slots:
+    /**
+     * @brief Emits dataChanged() for every contiguous range of rows changed since the last flush.
+     */
+    void flushChanges();
+
+private:
+    /**
+     * @brief Schedules a row to be announced on the next flush.
+     * @param row Unit index.
+     */
+    void markDirty(int row);
+
+    QVector<UnitState> units;  ///< State of every unit, indexed by row.
+    QVector<int> dirtyRows;    ///< Rows changed since the last flush.
+    QVector<bool> dirtyFlags;  ///< Per-row flag preventing duplicates in dirtyRows.
+    QTimer flushTimer;         ///< Single-shot timer coalescing changes into one flush per frame.
+};
+
+/**
+ * @class UnitFilterProxyModel
+ * @brief Sort/filter proxy selecting units by name and status.
+ *
+ * Dynamic sorting and filtering are enabled, so the proxy only re-evaluates
+ * rows reported by dataChanged() instead of re-sorting the whole table.
+ */
+class UnitFilterProxyModel : public QSortFilterProxyModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor.
+     * @param parent Optional parent.
+     */
+    explicit UnitFilterProxyModel(QObject *parent = nullptr);
+
+    /**
+     * @brief Sets the substring a unit name must contain.
+     * @param text Name filter; empty accepts every name.
+     */
+    void setNameFilter(const QString &text);
+
+    /**
+     * @brief Sets the status a unit must have.
+     * @param status Index of BlockStatus, or -1 to accept every status.
+     */
+    void setStatusFilter(int status);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    QString nameFilter;    ///< Current name filter.
+    int statusFilter = -1; ///< Current status filter, -1 if disabled.
+};
+
+#endif // UNITTABLEMODEL_H